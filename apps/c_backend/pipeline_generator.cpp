@@ -13,13 +13,23 @@ public:
     void generate() {
         Var x, y;
 
-        Func f, h;
+        Func f, g, h;
         f(x, y) = (input(clamp(x+2, 0, input.dim(0).extent()-1), clamp(y-2, 0, input.dim(1).extent()-1)) * 17)/13;
         h.define_extern("an_extern_stage", {f}, Int(16), 0, NameMangling::C);
-        output(x, y) = cast<uint16_t>(max(0, f(y, x) + f(x, y) + an_extern_func(x, y) + h()));
 
-        f.compute_root().vectorize(x, 8);
+        // Some operations with dedicated x86 instructions: a rounding
+        // average, a saturating add, and a widening multiply.
+        Expr a = cast<uint32_t>(f(x, y)), b = cast<uint32_t>(f(x + 1, y));
+        Expr avg = cast<uint16_t>((a + b + 1) / 2);
+        Expr sat = cast<uint16_t>(min(cast<uint32_t>(avg) + b, 65535));
+        g(x, y) = cast<uint16_t>((cast<uint32_t>(sat) * a) / 65536);
+
+        output(x, y) = cast<uint16_t>(max(0, f(y, x) + f(x, y) + g(x, y) + an_extern_func(x, y) + h()));
+
+        f.compute_root().vectorize(x, 8).parallel(y);
+        g.compute_root().vectorize(x, 16).parallel(y);
         h.compute_root();
+        output.parallel(y, 16);
     }
 };
 
@@ -3,6 +3,7 @@
 #include <cstdlib>
 
 #include "HalideBuffer.h"
+#include "halide_benchmark.h"
 #include "pipeline_c.h"
 #include "pipeline_native.h"
 
@@ -62,6 +63,15 @@ int main(int argc, char **argv) {
         }
     }
 
+    // Compare the speed of the C++ backend to the LLVM backend.
+    double t_native = Halide::Tools::benchmark(10, 10, [&]() {
+        pipeline_native(in, out_native);
+    });
+    double t_c = Halide::Tools::benchmark(10, 10, [&]() {
+        pipeline_c(in, out_c);
+    });
+    printf("LLVM backend: %gms\nC++ backend: %gms\n", t_native * 1e3, t_c * 1e3);
+
     printf("Success!\n");
     return 0;
 }
@@ -0,0 +1,94 @@
+#!/usr/bin/python3
+"""
+Measures how well a pipeline scales when run from several Python
+threads at once. Realize releases the GIL while the pipeline runs, so
+the threads should not serialize on it.
+
+Realizing the same Func from two threads at once isn't safe, because
+the compiled pipeline keeps per-call state in shared storage. Each
+thread here builds and compiles its own copy of the pipeline.
+"""
+
+from halide import *
+
+import numpy as np
+import threading
+import time
+
+
+def get_blur(input):
+    x, y = Var("x"), Var("y")
+
+    clamped = repeat_edge(input)
+
+    blur_x = Func("blur_x")
+    blur_y = Func("blur_y")
+    blur_x[x, y] = (clamped[x, y] + clamped[x + 1, y] + clamped[x + 2, y]) / 3
+    blur_y[x, y] = (blur_x[x, y] + blur_x[x, y + 1] + blur_x[x, y + 2]) / 3
+
+    # A serial schedule, so that all the parallelism comes from the
+    # Python threads.
+    blur_x.compute_at(blur_y, y).vectorize(x, 8)
+    blur_y.vectorize(x, 8)
+
+    return blur_y
+
+
+def run(input, input_data, num_threads, iterations):
+    # One pipeline per thread, compiled before the clock starts.
+    blurs = []
+    for _ in range(num_threads):
+        blur = get_blur(input)
+        blur.compile_jit()
+        blurs.append(blur)
+    outputs = [np.empty(input_data.shape, dtype=input_data.dtype, order="F")
+               for _ in range(num_threads)]
+
+    def work(blur, output_data):
+        output_image = Buffer(output_data)
+        for _ in range(iterations):
+            blur.realize(output_image)
+
+    threads = [threading.Thread(target=work, args=(b, o))
+               for b, o in zip(blurs, outputs)]
+    start = time.perf_counter()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    elapsed = time.perf_counter() - start
+
+    return num_threads * iterations / elapsed
+
+
+def main():
+    input = ImageParam(Float(32), 2, "input")
+
+    # A reversed view of the input, to exercise wrapping an array with
+    # negative strides without a copy.
+    input_data = np.random.rand(1536, 2560).astype(np.float32)
+    input_data = np.asfortranarray(input_data)[::-1, :]
+    input.set(Buffer(input_data))
+
+    iterations = 20
+    baseline = run(input, input_data, 1, iterations)
+    print("1 thread: %.1f realizations/s" % baseline)
+    for num_threads in [2, 4, 8]:
+        throughput = run(input, input_data, num_threads, iterations)
+        print("%d threads: %.1f realizations/s (%.2fx)" %
+              (num_threads, throughput, throughput / baseline))
+
+    # Check the result, including the orientation of the reversed input.
+    output_data = np.empty(input_data.shape, dtype=input_data.dtype, order="F")
+    get_blur(input).realize(Buffer(output_data))
+    padded = np.pad(input_data, ((0, 2), (0, 2)), mode="edge")
+    blur_x = (padded[:-2, :] + padded[1:-1, :] + padded[2:, :]) / 3
+    expected = (blur_x[:, :-2] + blur_x[:, 1:-1] + blur_x[:, 2:]) / 3
+    assert np.allclose(output_data, expected, atol=1e-5), "Wrong result"
+
+    print("Success!")
+    return 0
+
+
+if __name__ == "__main__":
+    main()
@@ -14,6 +14,7 @@
 #include "Func_Stage.h"
 #include "Func_VarOrRVar.h"
 #include "Func_gpu.h"
+#include "ReleaseGIL.h"
 
 #include <string>
 #include <vector>
@@ -49,25 +50,38 @@ h::Realization python_object_to_realization(p::object obj) {
 
 template <typename... Args>
 p::object func_realize(h::Func &f, Args... args) {
-    return realization_to_python_object(f.realize(args...));
+    std::vector<h::Buffer<>> buffers;
+    {
+        ReleaseGIL release_gil;
+        h::Realization r = f.realize(args...);
+        for (size_t i = 0; i < r.size(); i++) {
+            buffers.push_back(r[i]);
+        }
+    }
+    return realization_to_python_object(h::Realization(buffers));
 }
 
 template <typename... Args>
 void func_realize_into(h::Func &f, Args... args) {
+    ReleaseGIL release_gil;
     f.realize(args...);
 }
 
 template <typename... Args>
 void func_realize_tuple(h::Func &f, p::tuple obj, Args... args) {
-    f.realize(python_object_to_realization(obj), args...);
+    h::Realization r = python_object_to_realization(obj);
+    ReleaseGIL release_gil;
+    f.realize(r, args...);
 }
 
 void func_compile_jit0(h::Func &that) {
+    ReleaseGIL release_gil;
     that.compile_jit();
     return;
 }
 
 void func_compile_jit1(h::Func &that, const h::Target &target = h::get_target_from_environment()) {
+    ReleaseGIL release_gil;
     that.compile_jit(target);
     return;
 }
@@ -241,12 +255,20 @@ void defineFunc() {
              "may result in a non-deterministic routine that returns "
              "different values at different times or on different machines.");
 
+    // Realizing a Func isn't reentrant: the compiled pipeline it
+    // caches keeps per-call state, such as the user context, in
+    // shared storage. Threads may realize different Funcs at once,
+    // but not the same one.
     const char *realize_doc =
-        "Evaluate this function over some rectangular domain and return"
-        "the resulting buffer.";
+        "Evaluate this function over some rectangular domain and return "
+        "the resulting buffer. Other Python threads may run while the "
+        "pipeline is compiled and run, but they must not realize this "
+        "same Func at the same time: give each thread its own Func.";
 
     const char *realize_into_doc =
-        "Evaluate this function into the given buffer.";
+        "Evaluate this function into the given buffer. Other Python threads "
+        "may run while the pipeline is compiled and run, but they must not "
+        "realize this same Func at the same time: give each thread its own Func.";
 
     func_class
         .def("realize", &func_realize<>,
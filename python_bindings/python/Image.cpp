@@ -476,6 +476,76 @@ h::Buffer<> python_object_to_buffer(p::object obj) {
     return h::Buffer<>();
 }
 
+h::Type buffer_format_to_type(const char *format, Py_ssize_t itemsize) {
+    // Skip any native or little-endian byte-order prefix.
+    if (format == nullptr) {
+        format = "B";
+    } else if (*format == '@' || *format == '=' || *format == '<') {
+        format++;
+    }
+    if (format[0] == 0 || format[1] != 0) {
+        throw std::invalid_argument(std::string("Can't wrap a buffer with format ") + format);
+    }
+    const int bits = (int)itemsize * 8;
+    switch (format[0]) {
+    case 'b': case 'h': case 'i': case 'l': case 'q':
+        return h::Int(bits);
+    case 'B': case 'H': case 'I': case 'L': case 'Q':
+        return h::UInt(bits);
+    case 'f': case 'd':
+        return h::Float(bits);
+    default:
+        throw std::invalid_argument(std::string("Can't wrap a buffer with format ") + format);
+    }
+}
+
+// The name of the attribute of a Buffer wrapping a buffer-protocol
+// object that holds the exported view.
+const char *const buffer_view_attr = "_buffer_view";
+
+void release_buffer_view(PyObject *capsule) {
+    Py_buffer *view = (Py_buffer *)PyCapsule_GetPointer(capsule, nullptr);
+    PyBuffer_Release(view);
+    delete view;
+}
+
+/// Will create a Halide::Buffer object pointing to the memory of any
+/// Python object supporting the buffer protocol (numpy arrays,
+/// memoryviews, bytearrays, array.array, ...), with no copy.
+p::object python_buffer_to_buffer(p::object obj) {
+    Py_buffer *view = new Py_buffer;
+    if (PyObject_GetBuffer(obj.ptr(), view, PyBUF_RECORDS) != 0) {
+        delete view;
+        p::throw_error_already_set();
+    }
+    // The exporter may not resize or free the memory until the view
+    // is released, so hold on to the view for as long as the Buffer
+    // object exists. The capsule releases it when it's collected.
+    PyObject *capsule = PyCapsule_New(view, nullptr, release_buffer_view);
+    if (!capsule) {
+        PyBuffer_Release(view);
+        delete view;
+        p::throw_error_already_set();
+    }
+    p::object owner{p::handle<>(capsule)};
+
+    h::Type t = buffer_format_to_type(view->format, view->itemsize);
+    std::vector<halide_dimension_t> shape(view->ndim);
+    for (int i = 0; i < view->ndim; i++) {
+        if (view->strides[i] % view->itemsize != 0) {
+            throw std::invalid_argument("Can't wrap a buffer with a stride that isn't a multiple of the element size");
+        }
+        shape[i].min = 0;
+        shape[i].extent = (int32_t)view->shape[i];
+        shape[i].stride = (int32_t)(view->strides[i] / view->itemsize);
+    }
+    h::Buffer<> b(t, view->buf, view->ndim, shape.data());
+
+    p::object result = buffer_to_python_object(b);
+    p::setattr(result, buffer_view_attr, owner);
+    return result;
+}
+
 #ifdef USE_NUMPY
 
 bn::dtype type_to_dtype(const h::Type &t) {
@@ -512,6 +582,13 @@ p::object ndarray_to_buffer(bn::ndarray &array) {
     halide_dimension_t *shape =
         (halide_dimension_t *)__builtin_alloca(sizeof(halide_dimension_t) * dims);
     for (int i = 0; i < dims; i++) {
+        // Any stride works, including negative ones (e.g. from a
+        // reversing slice), as long as it's a whole number of
+        // elements. The host pointer is already the address of
+        // element zero.
+        if (array.strides(i) % t.bytes() != 0) {
+            throw std::invalid_argument("Can't wrap a numpy array with a stride that isn't a multiple of the element size");
+        }
         shape[i].min = 0;
         shape[i].extent = array.shape(i);
         shape[i].stride = array.strides(i) / t.bytes();
@@ -609,7 +686,16 @@ void defineBuffer() {
     defineBuffer_impl<float>("_float32", h::Float(32));
     defineBuffer_impl<double>("_float64", h::Float(64));
 
-    // "Buffer" will look as a class, but instead it will be simply a factory method
+    // "Buffer" will look as a class, but instead it will be simply a factory method.
+    // Boost.Python tries overloads in the reverse of the order they're
+    // defined, so this catch-all must come first.
+    p::def("Buffer", &python_buffer_to_buffer,
+           p::args("obj"),
+           p::with_custodian_and_ward_postcall<0, 1>(),  // the object reference count is increased
+           "Wrap any object supporting the Python buffer protocol in a Halide::Buffer."
+           "Any strides are allowed, including negative ones."
+           "Created Buffer refers to the object's memory (no copy).");
+
     p::def("Buffer", &BufferFactory::create_buffer0,
            p::args("type"),
            "Construct a zero-dimensional buffer of type T");
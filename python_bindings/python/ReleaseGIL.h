@@ -0,0 +1,24 @@
+#ifndef RELEASE_GIL_H
+#define RELEASE_GIL_H
+
+#include <boost/python.hpp>
+
+/** Releases the Python global interpreter lock for the lifetime of
+ * this object, so that other Python threads can run while we're busy
+ * compiling or running a pipeline. Nothing in its scope may touch
+ * Python objects. */
+class ReleaseGIL {
+    PyThreadState *state;
+
+public:
+    ReleaseGIL()
+        : state(PyEval_SaveThread()) {
+    }
+    ~ReleaseGIL() {
+        PyEval_RestoreThread(state);
+    }
+    ReleaseGIL(const ReleaseGIL &) = delete;
+    ReleaseGIL &operator=(const ReleaseGIL &) = delete;
+};
+
+#endif  // RELEASE_GIL_H
@@ -0,0 +1,21 @@
+#include "Halide.h"
+
+namespace {
+
+// A pipeline to build into a Python extension module with the
+// python_extension generator output.
+class Scale : public Halide::Generator<Scale> {
+public:
+    Input<Buffer<float>> input{"input", 2};
+    Input<float> factor{"factor"};
+    Output<Buffer<float>> output{"output", 2};
+
+    void generate() {
+        Var x, y;
+        output(x, y) = input(x, y) * factor + x;
+    }
+};
+
+}  // namespace
+
+HALIDE_REGISTER_GENERATOR(Scale, scale)
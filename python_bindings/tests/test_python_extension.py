@@ -0,0 +1,36 @@
+#!/usr/bin/python3
+
+# Runs the pipeline in python_extension_generator.cpp through the
+# extension module the generator emitted for it. Built and run by
+# "make test_python_extension".
+
+import numpy as np
+
+import scale
+
+def main():
+    # Dimension 0 of a buffer is axis 0 of the array, and must be
+    # dense, so use Fortran order.
+    input = np.asfortranarray(np.arange(12, dtype=np.float32).reshape(4, 3))
+    output = np.empty_like(input)
+
+    scale.scale(input, 2.0, output)
+    for x in range(4):
+        for y in range(3):
+            assert output[x, y] == input[x, y] * 2.0 + x, (x, y, output[x, y])
+
+    # Arguments can also be given by name.
+    output[:] = 0
+    scale.scale(factor=3.0, output=output, input=input)
+    for x in range(4):
+        for y in range(3):
+            assert output[x, y] == input[x, y] * 3.0 + x, (x, y, output[x, y])
+
+    names = [a[0] for a in scale.scale_arguments]
+    assert names == ["input", "factor", "output"], names
+
+    print("Success!")
+    return 0
+
+if __name__ == "__main__":
+    main()
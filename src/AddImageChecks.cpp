@@ -4,6 +4,8 @@
 #include "Substitute.h"
 #include "Simplify.h"
 
+#include <set>
+
 namespace Halide {
 namespace Internal {
 
@@ -12,6 +14,7 @@ using std::string;
 using std::map;
 using std::pair;
 using std::make_pair;
+using std::set;
 
 /* Find all the externally referenced buffers in a stmt */
 class FindBuffers : public IRGraphVisitor {
@@ -90,6 +93,100 @@ public:
     }
 };
 
+/* Find the variables a set of checks ultimately depends on, looking
+ * through the lets that will be wrapped around them. */
+class FindCheckInputs : public IRGraphVisitor {
+    const map<string, Expr> &lets;
+    set<string> bound, found;
+
+    using IRGraphVisitor::visit;
+
+    void visit(const Let *op) {
+        bound.insert(op->name);
+        IRGraphVisitor::visit(op);
+    }
+
+    void visit(const LetStmt *op) {
+        bound.insert(op->name);
+        IRGraphVisitor::visit(op);
+    }
+
+    void visit(const Variable *op) {
+        if (bound.count(op->name)) {
+            return;
+        }
+        auto it = lets.find(op->name);
+        if (it != lets.end()) {
+            include(it->second);
+        } else if (!found.count(op->name)) {
+            found.insert(op->name);
+            inputs.push_back(op);
+        }
+    }
+
+public:
+    vector<Expr> inputs;
+
+    FindCheckInputs(const map<string, Expr> &lets) : lets(lets) {}
+};
+
+/* Guard some checks so that they only run when the values they depend
+ * on differ from those of the last call that passed them. The values
+ * are packed into a signature of int32s that the runtime compares
+ * against a copy kept in a pipeline-owned state buffer. */
+Stmt cache_checks(Stmt checks, const map<string, Expr> &lets) {
+    FindCheckInputs finder(lets);
+    checks.accept(&finder);
+
+    vector<Expr> signature;
+    for (Expr e : finder.inputs) {
+        Type t = e.type();
+        if (t.is_handle()) {
+            // We can't tell what the checks depend on through a
+            // handle (e.g. the results of bounds queries to extern
+            // stages), so always run them.
+            debug(2) << "Not caching image checks, because they depend on " << e << "\n";
+            return checks;
+        }
+        if (t.is_float()) {
+            e = reinterpret(UInt(t.bits()), e);
+            t = e.type();
+        }
+        if (t.bits() > 32) {
+            signature.push_back(cast<int32_t>(e));
+            signature.push_back(cast<int32_t>(e >> make_const(t, 32)));
+        } else {
+            signature.push_back(cast<int32_t>(e));
+        }
+    }
+    if (signature.empty()) {
+        return checks;
+    }
+
+    auto storage = Buffer<void *>::make_scalar(unique_name("check_cache"));
+    storage() = nullptr;
+    Expr buf = Variable::make(type_of<halide_buffer_t *>(), storage.name() + ".buffer", storage);
+    Expr cache = Call::make(Handle(), Call::buffer_get_host, {buf}, Call::Extern);
+
+    string signature_name = unique_name("check_cache_signature");
+    Expr signature_var = Variable::make(Handle(), signature_name);
+    Expr size = (int)signature.size();
+
+    string hit_name = unique_name("check_cache_hit");
+    Expr hit_var = Variable::make(Int(32), hit_name);
+    Expr lookup = Call::make(Int(32), "halide_check_cache_lookup",
+                             {cache, signature_var, size}, Call::Extern);
+    Expr store = Call::make(Int(32), "halide_check_cache_store",
+                            {cache, signature_var, size}, Call::Extern);
+
+    Stmt result = IfThenElse::make(hit_var == 0, Block::make(checks, Evaluate::make(store)));
+    result = LetStmt::make(hit_name, lookup, result);
+    result = LetStmt::make(signature_name,
+                           Call::make(Handle(), Call::make_struct, signature, Call::Intrinsic),
+                           result);
+    return result;
+}
+
 Stmt add_image_checks(Stmt s,
                       const vector<Function> &outputs,
                       const Target &t,
@@ -98,6 +195,7 @@ Stmt add_image_checks(Stmt s,
                       const FuncValueBounds &fb) {
 
     bool no_asserts = t.has_feature(Target::NoAsserts);
+    bool check_cache = !no_asserts && t.has_feature(Target::CheckCache);
     bool no_bounds_query = t.has_feature(Target::NoBoundsQuery);
 
     // First hunt for all the referenced buffers
@@ -568,7 +666,7 @@ Stmt add_image_checks(Stmt s,
         }
     }
     // Inject the code that checks that no dimension math overflows
-    if (!no_asserts) {
+    if (!no_asserts && !check_cache) {
         for (size_t i = dims_no_overflow_asserts.size(); i > 0; i--) {
             s = Block::make(dims_no_overflow_asserts[i-1], s);
         }
@@ -589,7 +687,34 @@ Stmt add_image_checks(Stmt s,
     // all in reverse order compared to execution, as we incrementally
     // prepending code.
 
-    if (!no_asserts) {
+    if (check_cache) {
+        // Everything but the host pointer checks depends only on the
+        // shapes, types, and scalar params, so gather those checks
+        // into one block that is skipped when they haven't changed
+        // since the last call that passed them.
+        vector<Stmt> checks;
+        checks.insert(checks.end(), asserts_elem_size.begin(), asserts_elem_size.end());
+        checks.insert(checks.end(), asserts_required.begin(), asserts_required.end());
+        checks.insert(checks.end(), asserts_constrained.begin(), asserts_constrained.end());
+        Stmt overflow_checks = Block::make(dims_no_overflow_asserts);
+        if (overflow_checks.defined()) {
+            for (size_t i = lets_overflow.size(); i > 0; i--) {
+                overflow_checks = LetStmt::make(lets_overflow[i-1].first, lets_overflow[i-1].second, overflow_checks);
+            }
+            checks.push_back(substitute(replace_with_constrained, overflow_checks));
+        }
+
+        if (!checks.empty()) {
+            map<string, Expr> lets;
+            for (const auto &l : lets_required) {
+                lets[l.first] = l.second;
+            }
+            for (const auto &l : lets_constrained) {
+                lets[l.first] = l.second;
+            }
+            s = Block::make(cache_checks(Block::make(checks), lets), s);
+        }
+    } else if (!no_asserts) {
         // Inject the code that checks the constraints are correct.
         for (size_t i = asserts_constrained.size(); i > 0; i--) {
             s = Block::make(asserts_constrained[i-1], s);
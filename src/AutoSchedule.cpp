@@ -1178,6 +1178,11 @@ struct Partitioner {
     void reorder_dims(Stage f_handle, int stage_num, Definition def,
                       map<string, Expr> strides, AutoSchedule &sched);
 
+    // Return true if 'f' is a pipeline output that is written once, never
+    // read by the pipeline, and larger than the last level cache, so that
+    // it is worth writing with non-temporal stores.
+    bool should_store_non_temporal(const Function &f);
+
     // Helper functions to display partition information of the pipeline.
     void disp_pipeline_costs();
     void disp_pipeline_bounds();
@@ -2429,6 +2434,9 @@ pair<VarOrRVar, VarOrRVar> Partitioner::split_dim(
         case TailStrategy::ShiftInwards:
             oss << ", TailStrategy::ShiftInwards)";
             break;
+        case TailStrategy::Predicate:
+            oss << ", TailStrategy::Predicate)";
+            break;
         case TailStrategy::Auto:
             oss << ")";
             break;
@@ -2649,6 +2657,21 @@ public :
     }
 };
 
+bool Partitioner::should_store_non_temporal(const Function &f) {
+    bool is_output = std::find_if(outputs.begin(), outputs.end(),
+                                  [&f](const Function &o) { return o.name() == f.name(); })
+        != outputs.end();
+    if (!is_output || !f.updates().empty() || f.has_extern_definition()) {
+        return false;
+    }
+    const auto &iter = children.find(FStage(f, 0));
+    if (iter != children.end() && !iter->second.empty()) {
+        return false;
+    }
+    Expr size = costs.region_size(f.name(), get_element(pipeline_bounds, f.name()));
+    return size.defined() && can_prove(size > arch_params.last_level_cache_size);
+}
+
 void Partitioner::generate_group_cpu_schedule(
         const Group &g, const Target &t,
         const map<FStage, DimBounds> &group_loop_bounds,
@@ -2679,6 +2702,10 @@ void Partitioner::generate_group_cpu_schedule(
     } else {
         Func(g_out).compute_root();
         sched.push_schedule(f_handle.name(), g.output.stage_num, "compute_root()", {});
+        if (should_store_non_temporal(g_out)) {
+            Func(g_out).store_non_temporal();
+            sched.push_schedule(f_handle.name(), g.output.stage_num, "store_non_temporal()", {});
+        }
     }
 
     if (g.output.func.has_extern_definition()) {
@@ -210,6 +210,26 @@ Func mirror_interior(const Func &source,
     return bounded;
 }
 
+Func &stage_padded(Func &bounded, LoopLevel at, int vector_width) {
+    user_assert(bounded.defined())
+        << "stage_padded called on undefined Func " << bounded.name() << "\n";
+    user_assert(!bounded.has_update_definition())
+        << "stage_padded called on Func " << bounded.name()
+        << ", which has update definitions. It should be the Func returned by a boundary condition.\n";
+    user_assert(vector_width >= 1)
+        << "stage_padded called with vector width " << vector_width
+        << " for Func " << bounded.name() << "\n";
+
+    // The store level follows the compute level, so the staging
+    // buffer only holds the region needed by one iteration of the
+    // loop, and is dense.
+    bounded.compute_at(at);
+    if (vector_width > 1 && bounded.dimensions() > 0) {
+        bounded.vectorize(bounded.args()[0], vector_width);
+    }
+    return bounded;
+}
+
 }
 
 }
@@ -260,6 +260,32 @@ inline NO_INLINE Func mirror_interior(const T &func_like, Bounds&&... bounds) {
 }
 // @}
 
+/** Schedule a Func returned by one of the boundary conditions above
+ *  to be computed into a padded staging buffer once per iteration of
+ *  the given loop level, instead of being inlined into its consumers.
+ *  The buffer covers the region the consumers need at that level,
+ *  including the part outside the image, so the consumers read it
+ *  with dense loads and no clamps or selects. The boundary handling
+ *  is paid once per staged value, and loop partitioning reduces the
+ *  interior of the staging loop to a straight copy. This pays off for
+ *  small tiles and multi-dimensional stencils, where each input value
+ *  is read many times and a large fraction of tiles touch an edge.
+ *
+ *  If vector_width is greater than one, the innermost dimension of the
+ *  staging loop is vectorized by that amount.
+ *
+ *  For example, to stage the padded input for each 32x32 tile of a blur:
+ \code
+ Func clamped = BoundaryConditions::repeat_edge(input);
+ blur(x, y) = clamped(x - 1, y) + clamped(x, y) + clamped(x + 1, y);
+ blur.tile(x, y, xo, yo, xi, yi, 32, 32).vectorize(xi, 8);
+ BoundaryConditions::stage_padded(clamped, LoopLevel(blur, xo), 8);
+ \endcode
+ *
+ *  Returns a reference to the staged Func, for further scheduling.
+ */
+EXPORT Func &stage_padded(Func &bounded, LoopLevel at, int vector_width = 1);
+
 }
 
 }
@@ -1002,4 +1002,11 @@ int CodeGen_ARM::native_vector_bits() const {
     return 128;
 }
 
+int CodeGen_ARM::carried_value_registers() const {
+    // Use half the 128-bit register file for carried values, and
+    // leave the rest for the computation.
+    int registers = target.bits == 32 ? 16 : 32;
+    return registers / 2;
+}
+
 }}
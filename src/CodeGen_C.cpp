@@ -3,6 +3,8 @@
 
 #include "CodeGen_C.h"
 #include "CodeGen_Internal.h"
+#include "ConciseCasts.h"
+#include "IRMatch.h"
 #include "Substitute.h"
 #include "IROperator.h"
 #include "Param.h"
@@ -1150,9 +1152,129 @@ private:
     #define halide_cpp_use_native_vector(type, lanes) (false)
 #endif
 
+)INLINE_CODE";
+
+        // Operations that x86 has single instructions for, but which
+        // a C++ compiler is unlikely to recognize in their expanded
+        // form. Each is applied 256 or 128 bits at a time using
+        // intrinsics when the compiler is targeting AVX2 or SSE2, and
+        // lane-by-lane otherwise. The round trip through the arrays
+        // folds away for the native vector widths.
+        const char *x86_vector_decl = R"INLINE_CODE(
+#include <limits>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define HALIDE_CPP_HAVE_SSE2 1
+    #include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+    #define HALIDE_CPP_HAVE_AVX2 1
+    #include <immintrin.h>
+#endif
+
+template<typename T>
+inline T halide_x86_saturate(int32_t x) {
+    return (T)::halide_cpp_min(::halide_cpp_max(x, (int32_t)std::numeric_limits<T>::min()),
+                               (int32_t)std::numeric_limits<T>::max());
+}
+
+struct halide_x86_adds {
+    template<typename T>
+    static T scalar(T a, T b) {return halide_x86_saturate<T>((int32_t)a + (int32_t)b);}
+#if HALIDE_CPP_HAVE_SSE2
+    static __m128i sse2(__m128i a, __m128i b, int8_t) {return _mm_adds_epi8(a, b);}
+    static __m128i sse2(__m128i a, __m128i b, uint8_t) {return _mm_adds_epu8(a, b);}
+    static __m128i sse2(__m128i a, __m128i b, int16_t) {return _mm_adds_epi16(a, b);}
+    static __m128i sse2(__m128i a, __m128i b, uint16_t) {return _mm_adds_epu16(a, b);}
+#endif
+#if HALIDE_CPP_HAVE_AVX2
+    static __m256i avx2(__m256i a, __m256i b, int8_t) {return _mm256_adds_epi8(a, b);}
+    static __m256i avx2(__m256i a, __m256i b, uint8_t) {return _mm256_adds_epu8(a, b);}
+    static __m256i avx2(__m256i a, __m256i b, int16_t) {return _mm256_adds_epi16(a, b);}
+    static __m256i avx2(__m256i a, __m256i b, uint16_t) {return _mm256_adds_epu16(a, b);}
+#endif
+};
+
+struct halide_x86_subs {
+    template<typename T>
+    static T scalar(T a, T b) {return halide_x86_saturate<T>((int32_t)a - (int32_t)b);}
+#if HALIDE_CPP_HAVE_SSE2
+    static __m128i sse2(__m128i a, __m128i b, int8_t) {return _mm_subs_epi8(a, b);}
+    static __m128i sse2(__m128i a, __m128i b, uint8_t) {return _mm_subs_epu8(a, b);}
+    static __m128i sse2(__m128i a, __m128i b, int16_t) {return _mm_subs_epi16(a, b);}
+    static __m128i sse2(__m128i a, __m128i b, uint16_t) {return _mm_subs_epu16(a, b);}
+#endif
+#if HALIDE_CPP_HAVE_AVX2
+    static __m256i avx2(__m256i a, __m256i b, int8_t) {return _mm256_subs_epi8(a, b);}
+    static __m256i avx2(__m256i a, __m256i b, uint8_t) {return _mm256_subs_epu8(a, b);}
+    static __m256i avx2(__m256i a, __m256i b, int16_t) {return _mm256_subs_epi16(a, b);}
+    static __m256i avx2(__m256i a, __m256i b, uint16_t) {return _mm256_subs_epu16(a, b);}
+#endif
+};
+
+// Average, rounding up.
+struct halide_x86_avg {
+    template<typename T>
+    static T scalar(T a, T b) {return (T)(((uint32_t)a + (uint32_t)b + 1) >> 1);}
+#if HALIDE_CPP_HAVE_SSE2
+    static __m128i sse2(__m128i a, __m128i b, uint8_t) {return _mm_avg_epu8(a, b);}
+    static __m128i sse2(__m128i a, __m128i b, uint16_t) {return _mm_avg_epu16(a, b);}
+#endif
+#if HALIDE_CPP_HAVE_AVX2
+    static __m256i avx2(__m256i a, __m256i b, uint8_t) {return _mm256_avg_epu8(a, b);}
+    static __m256i avx2(__m256i a, __m256i b, uint16_t) {return _mm256_avg_epu16(a, b);}
+#endif
+};
+
+// The high half of a widening multiply.
+struct halide_x86_mulhi {
+    // Widen unsigned values to uint32_t, so that the product can't
+    // overflow a signed int.
+    static int16_t scalar(int16_t a, int16_t b) {return (int16_t)(((int32_t)a * (int32_t)b) >> 16);}
+    static uint16_t scalar(uint16_t a, uint16_t b) {return (uint16_t)(((uint32_t)a * (uint32_t)b) >> 16);}
+#if HALIDE_CPP_HAVE_SSE2
+    static __m128i sse2(__m128i a, __m128i b, int16_t) {return _mm_mulhi_epi16(a, b);}
+    static __m128i sse2(__m128i a, __m128i b, uint16_t) {return _mm_mulhi_epu16(a, b);}
+#endif
+#if HALIDE_CPP_HAVE_AVX2
+    static __m256i avx2(__m256i a, __m256i b, int16_t) {return _mm256_mulhi_epi16(a, b);}
+    static __m256i avx2(__m256i a, __m256i b, uint16_t) {return _mm256_mulhi_epu16(a, b);}
+#endif
+};
+
+template<typename Op, typename Vec>
+inline Vec halide_x86_binop(const Vec &a, const Vec &b) {
+    typedef typename Vec::ElementType T;
+    const size_t lanes = Vec::Lanes;
+    T va[lanes], vb[lanes], vr[lanes];
+    a.store(va, 0);
+    b.store(vb, 0);
+    size_t i = 0;
+#if HALIDE_CPP_HAVE_AVX2
+    for (; i + 32 / sizeof(T) <= lanes; i += 32 / sizeof(T)) {
+        __m256i r = Op::avx2(_mm256_loadu_si256((const __m256i *)(va + i)),
+                             _mm256_loadu_si256((const __m256i *)(vb + i)), T());
+        _mm256_storeu_si256((__m256i *)(vr + i), r);
+    }
+#endif
+#if HALIDE_CPP_HAVE_SSE2
+    for (; i + 16 / sizeof(T) <= lanes; i += 16 / sizeof(T)) {
+        __m128i r = Op::sse2(_mm_loadu_si128((const __m128i *)(va + i)),
+                             _mm_loadu_si128((const __m128i *)(vb + i)), T());
+        _mm_storeu_si128((__m128i *)(vr + i), r);
+    }
+#endif
+    for (; i < lanes; i++) {
+        vr[i] = Op::scalar(va[i], vb[i]);
+    }
+    return Vec::load(vr, 0);
+}
+
 )INLINE_CODE";
 
         stream << cpp_vector_decl << native_vector_decl << vector_selection_decl;
+        if (target.arch == Target::X86) {
+            stream << x86_vector_decl;
+        }
 
         for (const auto &t : vector_types) {
             string name = type_to_c_type(t, false, false);
@@ -1734,6 +1856,57 @@ void CodeGen_C::visit(const Variable *op) {
 }
 
 void CodeGen_C::visit(const Cast *op) {
+    if (target.arch == Target::X86 && op->type.is_vector()) {
+        // Look for the same narrowing patterns CodeGen_X86 uses, and
+        // call the helpers in the x86 vector prologue for them.
+        using namespace Halide::ConciseCasts;
+
+        Expr wild_i16x = Variable::make(Int(16, 0), "*");
+        Expr wild_u16x = Variable::make(UInt(16, 0), "*");
+        Expr wild_i32x = Variable::make(Int(32, 0), "*");
+        Expr wild_u32x = Variable::make(UInt(32, 0), "*");
+
+        struct Pattern {
+            Type type;
+            const char *op;
+            Expr pattern;
+        };
+
+        Pattern patterns[] = {
+            {Int(8), "halide_x86_adds", i8_sat(wild_i16x + wild_i16x)},
+            {Int(8), "halide_x86_subs", i8_sat(wild_i16x - wild_i16x)},
+            {UInt(8), "halide_x86_adds", u8_sat(wild_u16x + wild_u16x)},
+            {UInt(8), "halide_x86_subs", u8(max(wild_i16x - wild_i16x, 0))},
+            {Int(16), "halide_x86_adds", i16_sat(wild_i32x + wild_i32x)},
+            {Int(16), "halide_x86_subs", i16_sat(wild_i32x - wild_i32x)},
+            {UInt(16), "halide_x86_adds", u16_sat(wild_u32x + wild_u32x)},
+            {UInt(16), "halide_x86_subs", u16(max(wild_i32x - wild_i32x, 0))},
+            {Int(16), "halide_x86_mulhi", i16((wild_i32x * wild_i32x) / 65536)},
+            {UInt(16), "halide_x86_mulhi", u16((wild_u32x * wild_u32x) / 65536)},
+            {UInt(8), "halide_x86_avg", u8(((wild_u16x + wild_u16x) + 1) / 2)},
+            {UInt(16), "halide_x86_avg", u16(((wild_u32x + wild_u32x) + 1) / 2)},
+        };
+
+        vector<Expr> matches;
+        for (const Pattern &p : patterns) {
+            if (op->type.element_of() != p.type ||
+                !expr_match(p.pattern, op, matches)) {
+                continue;
+            }
+            // The operands must fit in the narrow type.
+            bool match = true;
+            for (Expr &m : matches) {
+                m = lossless_cast(op->type, m);
+                match = match && m.defined();
+            }
+            if (match) {
+                string a = print_expr(matches[0]);
+                string b = print_expr(matches[1]);
+                print_assignment(op->type, string("halide_x86_binop<") + p.op + ">(" + a + ", " + b + ")");
+                return;
+            }
+        }
+    }
     id = print_cast_expr(op->type, op->value);
 }
 
@@ -1950,6 +2123,10 @@ void CodeGen_C::visit(const Call *op) {
         internal_assert(op->args.size() == 3);
         Expr e = lower_lerp(op->args[0], op->args[1], op->args[2]);
         rhs << print_expr(e);
+    } else if (op->is_intrinsic(Call::likely)) {
+        // Only a hint, which we drop.
+        internal_assert(op->args.size() == 1);
+        rhs << print_expr(op->args[0]);
     } else if (op->is_intrinsic(Call::absd)) {
         internal_assert(op->args.size() == 2);
         Expr a = op->args[0];
@@ -2135,14 +2312,25 @@ void CodeGen_C::visit(const Call *op) {
         user_error << "Signed integer overflow occurred during constant-folding. Signed"
             " integer overflow for int32 and int64 is undefined behavior in"
             " Halide.\n";
+    } else if (op->is_intrinsic(Call::non_temporal_fence)) {
+        // The C backend doesn't emit non-temporal stores, so there's
+        // nothing to order.
+        rhs << "0";
     } else if (op->is_intrinsic(Call::prefetch)) {
-        user_assert((op->args.size() == 4) && is_one(op->args[2]))
+        // Format: {base, offset, extent0, stride0, hint}
+        user_assert((op->args.size() == 5) && is_one(op->args[2]))
             << "Only prefetch of 1 cache line is supported in C backend.\n";
         const Variable *base = op->args[0].as<Variable>();
         internal_assert(base && base->type.is_handle());
+        const int64_t *hint = as_const_int(op->args[4]);
+        internal_assert(hint) << "Prefetch hint should be a constant\n";
+        PrefetchHint h = (PrefetchHint)*hint;
+        bool write = (h == PrefetchHint::Write || h == PrefetchHint::WriteNonTemporal);
+        bool non_temporal = (h == PrefetchHint::ReadNonTemporal || h == PrefetchHint::WriteNonTemporal);
         rhs << "__builtin_prefetch("
             << "((" << print_type(op->type) << " *)" << print_name(base->name)
-            << " + " << print_expr(op->args[1]) << "), 1)";
+            << " + " << print_expr(op->args[1]) << "), "
+            << (write ? 1 : 0) << ", " << (non_temporal ? 0 : 3) << ")";
     } else if (op->is_intrinsic(Call::indeterminate_expression)) {
         user_error << "Indeterminate expression occurred during constant-folding.\n";
     } else if (op->is_intrinsic(Call::size_of_halide_buffer_t)) {
@@ -2379,16 +2567,49 @@ void CodeGen_C::visit(const ProducerConsumer *op) {
 }
 
 void CodeGen_C::visit(const For *op) {
+    string id_min = print_expr(op->min);
+    string id_extent = print_expr(op->extent);
+
     if (op->for_type == ForType::Parallel) {
+        // Run the body as a task on the Halide thread pool, so that
+        // we share its threads and respect any custom
+        // halide_do_par_for. The body becomes a lambda capturing
+        // everything by reference, which is safe because
+        // halide_do_par_for doesn't return until every task is
+        // done. A non-capturing lambda that calls it through the
+        // closure pointer serves as the task function. Any error
+        // returned from the body is propagated by halide_do_par_for.
+        string task = "par_for_" + print_name(op->name);
         do_indent();
-        stream << "#pragma omp parallel for\n";
-    } else {
-        internal_assert(op->for_type == ForType::Serial)
-            << "Can only emit serial or parallel for loops to C\n";
+        stream << "// parallel for " << op->name << "\n";
+        do_indent();
+        stream << "auto " << task << " = [&](int " << print_name(op->name) << ") -> int\n";
+        open_scope();
+        op->body.accept(this);
+        do_indent();
+        stream << "return 0;\n";
+        close_scope("");
+        do_indent();
+        stream << ";\n";
+
+        string id_result = unique_name('_');
+        do_indent();
+        stream << "int " << id_result << " = halide_do_par_for(_ucon, "
+               << "[](void *, int idx, uint8_t *closure) -> int { "
+               << "return (*(decltype(" << task << ") *)closure)(idx); }, "
+               << id_min << ", " << id_extent << ", "
+               << "(uint8_t *)&" << task << ");\n";
+        do_indent();
+        stream << "if (" << id_result << " != 0)\n";
+        open_scope();
+        do_indent();
+        stream << "return " << id_result << ";\n";
+        close_scope("");
+        return;
     }
 
-    string id_min = print_expr(op->min);
-    string id_extent = print_expr(op->extent);
+    internal_assert(op->for_type == ForType::Serial)
+        << "Can only emit serial or parallel for loops to C\n";
 
     do_indent();
     stream << "for (int "
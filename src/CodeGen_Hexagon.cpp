@@ -216,11 +216,13 @@ void CodeGen_Hexagon::compile_func(const LoweredFunc &f,
     // want to carry across loop iterations.
     debug(2) << "Lowering after aligning loads:\n" << body << "\n\n";
 
-    debug(1) << "Carrying values across loop iterations...\n";
-    // Use at most 16 vector registers for carrying values.
-    body = loop_carry(body, 16);
-    body = simplify(body);
-    debug(2) << "Lowering after forwarding stores:\n" << body << "\n\n";
+    if (!target.has_feature(Target::NoLoopCarry)) {
+        debug(1) << "Carrying values across loop iterations...\n";
+        // Use at most 16 vector registers for carrying values.
+        body = loop_carry(body, 16);
+        body = simplify(body);
+        debug(2) << "Lowering after forwarding stores:\n" << body << "\n\n";
+    }
 
     // We can't deal with bool vectors, convert them to integer vectors.
     debug(1) << "Eliminating boolean vectors from Hexagon code...\n";
@@ -1724,7 +1726,9 @@ void CodeGen_Hexagon::visit(const Call *op) {
     }
 
     if (op->is_intrinsic(Call::prefetch)) {
-        internal_assert((op->args.size() == 4) || (op->args.size() == 6))
+        // The trailing hint arg is ignored; Hexagon's l2fetch has no
+        // read/write or temporal variants.
+        internal_assert((op->args.size() == 5) || (op->args.size() == 7))
             << "Hexagon only supports 1D or 2D prefetch\n";
 
         vector<llvm::Value *> args;
@@ -1734,9 +1738,9 @@ void CodeGen_Hexagon::visit(const Call *op) {
         args.push_back(codegen(extent_0_bytes));
 
         llvm::Function *prefetch_fn = nullptr;
-        if (op->args.size() == 4) { // 1D prefetch: {base, offset, extent0, stride0}
+        if (op->args.size() == 5) { // 1D prefetch: {base, offset, extent0, stride0, hint}
             prefetch_fn = module->getFunction("_halide_prefetch");
-        } else { // 2D prefetch: {base, offset, extent0, stride0, extent1, stride1}
+        } else { // 2D prefetch: {base, offset, extent0, stride0, extent1, stride1, hint}
             prefetch_fn = module->getFunction("_halide_prefetch_2d");
             args.push_back(codegen(op->args[4]));
             Expr stride_1_bytes = op->args[5] * op->type.bytes();
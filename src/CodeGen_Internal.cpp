@@ -162,6 +162,7 @@ bool function_takes_user_context(const std::string &name) {
         "halide_profiler_memory_allocate",
         "halide_profiler_memory_free",
         "halide_profiler_pipeline_start",
+        "halide_profiler_get_counters",
         "halide_profiler_pipeline_end",
         "halide_profiler_stack_peak_update",
         "halide_spawn_thread",
@@ -171,7 +172,10 @@ bool function_takes_user_context(const std::string &name) {
         "halide_trace_helper",
         "halide_memoization_cache_lookup",
         "halide_memoization_cache_store",
+        "halide_memoization_cache_copy",
         "halide_memoization_cache_release",
+        "halide_check_cache_lookup",
+        "halide_check_cache_store",
         "halide_cuda_run",
         "halide_opencl_run",
         "halide_opengl_run",
@@ -18,6 +18,7 @@
 #include "MatlabWrapper.h"
 #include "IntegerDivisionTable.h"
 #include "CSE.h"
+#include "LoopCarry.h"
 
 #include "CodeGen_X86.h"
 #include "CodeGen_GPU_Host.h"
@@ -663,6 +664,33 @@ void CodeGen_LLVM::end_func(const std::vector<LoweredArgument>& args) {
     current_function_args.clear();
 }
 
+namespace {
+// Find the buffers named by non_temporal_fence calls.
+class FindNonTemporalBuffers : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Call *op) {
+        if (op->is_intrinsic(Call::non_temporal_fence)) {
+            for (Expr arg : op->args) {
+                const StringImm *name = arg.as<StringImm>();
+                internal_assert(name);
+                buffers.insert(name->value);
+            }
+        }
+        IRVisitor::visit(op);
+    }
+
+public:
+    std::set<string> &buffers;
+    FindNonTemporalBuffers(std::set<string> &b) : buffers(b) {}
+};
+
+void find_non_temporal_buffers(Stmt s, std::set<string> &buffers) {
+    FindNonTemporalBuffers finder(buffers);
+    s.accept(&finder);
+}
+}
+
 void CodeGen_LLVM::compile_func(const LoweredFunc &f, const std::string &simple_name,
                                 const std::string &extern_name) {
     // Generate the function declaration and argument unpacking code.
@@ -688,9 +716,26 @@ void CodeGen_LLVM::compile_func(const LoweredFunc &f, const std::string &simple_
         }
     }
 
-     // Generate the function body.
+    Stmt body = f.body;
+
+    non_temporal_buffers.clear();
+    if (use_non_temporal_stores()) {
+        find_non_temporal_buffers(body, non_temporal_buffers);
+    }
+
+    int registers = carried_value_registers();
+    if (registers > 0 && !target.has_feature(Target::NoLoopCarry)) {
+        debug(1) << "Carrying values across loop iterations...\n";
+        Stmt carried = loop_carry(body, registers, native_vector_bits());
+        if (!carried.same_as(body)) {
+            body = simplify(carried);
+            debug(2) << "Function body after carrying values:\n" << body << "\n\n";
+        }
+    }
+
+    // Generate the function body.
     debug(1) << "Generating llvm bitcode for function " << f.name << "...\n";
-    f.body.accept(this);
+    body.accept(this);
 
     // Clean up and return.
     end_func(f.args);
@@ -1030,15 +1075,20 @@ void CodeGen_LLVM::optimize_module() {
     module_pass_manager.add(createTargetTransformInfoWrapperPass(TM ? TM->getTargetIRAnalysis() : TargetIRAnalysis()));
     function_pass_manager.add(createTargetTransformInfoWrapperPass(TM ? TM->getTargetIRAnalysis() : TargetIRAnalysis()));
 
+    // When compile time matters more than the quality of the code,
+    // run a minimal pipeline and skip the vectorizers, which are
+    // among the most expensive passes.
+    bool fast_compile = target.has_feature(Target::FastCompile);
+
     PassManagerBuilder b;
-    b.OptLevel = 3;
+    b.OptLevel = fast_compile ? 1 : 3;
 #if LLVM_VERSION >= 50
     b.Inliner = createFunctionInliningPass(b.OptLevel, 0, false);
 #else
     b.Inliner = createFunctionInliningPass(b.OptLevel, 0);
 #endif
-    b.LoopVectorize = true;
-    b.SLPVectorize = true;
+    b.LoopVectorize = !fast_compile;
+    b.SLPVectorize = !fast_compile;
 
 #if LLVM_VERSION >= 50
     if (TM) {
@@ -2099,6 +2149,11 @@ void CodeGen_LLVM::visit(const Call *op) {
 
         value = builder->CreateCall(debug_to_file, args);
 
+    } else if (op->is_intrinsic(Call::likely)) {
+        // Only meaningful as the condition of an IfThenElse, where
+        // it's handled directly.
+        internal_assert(op->args.size() == 1);
+        value = codegen(op->args[0]);
     } else if (op->is_intrinsic(Call::bitwise_and)) {
         internal_assert(op->args.size() == 2);
         value = builder->CreateAnd(codegen(op->args[0]), codegen(op->args[1]));
@@ -2634,11 +2689,33 @@ void CodeGen_LLVM::visit(const Call *op) {
 
         llvm::CallInst *call = builder->CreateCall(base_fn->getFunctionType(), phi, call_args);
         value = call;
+    } else if (op->is_intrinsic(Call::non_temporal_fence)) {
+        // Targets that emit non-temporal stores override this to
+        // order them.
+        value = ConstantInt::get(i32_t, 0);
     } else if (op->is_intrinsic(Call::prefetch)) {
-        user_assert((op->args.size() == 4) && is_one(op->args[2]))
+        // Format: {base, offset, extent0, stride0, hint}
+        user_assert((op->args.size() == 5) && is_one(op->args[2]))
             << "Only prefetch of 1 cache line is supported.\n";
 
-        llvm::Function *prefetch_fn = module->getFunction("_halide_prefetch");
+        const int64_t *hint = as_const_int(op->args[4]);
+        internal_assert(hint) << "Prefetch hint should be a constant\n";
+        const char *fn_name = nullptr;
+        switch ((PrefetchHint)*hint) {
+        case PrefetchHint::Read:
+            fn_name = "_halide_prefetch_read";
+            break;
+        case PrefetchHint::Write:
+            fn_name = "_halide_prefetch_write";
+            break;
+        case PrefetchHint::ReadNonTemporal:
+            fn_name = "_halide_prefetch_read_nt";
+            break;
+        case PrefetchHint::WriteNonTemporal:
+            fn_name = "_halide_prefetch_write_nt";
+            break;
+        }
+        llvm::Function *prefetch_fn = module->getFunction(fn_name);
         internal_assert(prefetch_fn);
 
         vector<llvm::Value *> args;
@@ -3179,6 +3256,13 @@ void CodeGen_LLVM::visit(const Store *op) {
                 Value *vec_ptr = builder->CreatePointerCast(elt_ptr, slice_val->getType()->getPointerTo());
                 StoreInst *store = builder->CreateAlignedStore(slice_val, vec_ptr, alignment);
                 add_tbaa_metadata(store, op->name, slice_index);
+                if (slice_lanes > 1 && non_temporal_buffers.count(op->name)) {
+                    // LLVM only uses a non-temporal instruction if
+                    // the store is sufficiently aligned, and
+                    // otherwise ignores this.
+                    llvm::MDNode *one = llvm::MDNode::get(*context, {ConstantAsMetadata::get(builder->getInt32(1))});
+                    store->setMetadata(LLVMContext::MD_nontemporal, one);
+                }
             }
         } else if (ramp) {
             Type ptr_type = value_type.element_of();
@@ -3239,7 +3323,14 @@ void CodeGen_LLVM::visit(const IfThenElse *op) {
     BasicBlock *true_bb = BasicBlock::Create(*context, "true_bb", function);
     BasicBlock *false_bb = BasicBlock::Create(*context, "false_bb", function);
     BasicBlock *after_bb = BasicBlock::Create(*context, "after_bb", function);
-    builder->CreateCondBr(codegen(op->condition), true_bb, false_bb);
+    // A likely tag surviving to here came from a branch profile (see
+    // apply_branch_profile), and tells us which way the branch goes.
+    const Call *c = op->condition.as<Call>();
+    if (c && c->is_intrinsic(Call::likely)) {
+        builder->CreateCondBr(codegen(c->args[0]), true_bb, false_bb, very_likely_branch);
+    } else {
+        builder->CreateCondBr(codegen(op->condition), true_bb, false_bb);
+    }
 
     builder->SetInsertPoint(true_bb);
     codegen(op->then_case);
@@ -107,6 +107,17 @@ protected:
     /** What's the natural vector bit-width to use for loads, stores, etc. */
     virtual int native_vector_bits() const = 0;
 
+    /** How many registers of native_vector_bits() each may be used to
+     * carry loaded values across loop iterations (see
+     * LoopCarry.h). Zero disables the optimization, as does
+     * Target::NoLoopCarry. */
+    virtual int carried_value_registers() const {return 0;}
+
+    /** Should dense vector stores to buffers named by a
+     * non_temporal_fence intrinsic be marked non-temporal? (see
+     * NonTemporalStores.h) */
+    virtual bool use_non_temporal_stores() const {return false;}
+
     /** State needed by llvm for code generation, including the
      * current module, function, context, builder, and most recently
      * generated llvm value. */
@@ -381,6 +392,9 @@ protected:
      * guarantee their alignment) */
     std::set<std::string> external_buffer;
 
+    /** Which buffers should be written with non-temporal stores */
+    std::set<std::string> non_temporal_buffers;
+
     /** The user_context argument. May be a constant null if the
      * function is being compiled without a user context. */
     llvm::Value *get_user_context() const;
@@ -363,6 +363,12 @@ void CodeGen_X86::visit(const Call *op) {
                           cast(wider, op->args[0]) <<
                           cast(wider, op->args[1]));
         codegen(equiv);
+    } else if (op->is_intrinsic(Call::non_temporal_fence)) {
+        // Non-temporal stores are weakly ordered, so make them
+        // visible before anything that follows.
+        llvm::Function *fn = llvm::Intrinsic::getDeclaration(module.get(), llvm::Intrinsic::x86_sse_sfence);
+        builder->CreateCall(fn);
+        value = ConstantInt::get(i32_t, 0);
     } else {
         CodeGen_Posix::visit(op);
     }
@@ -437,4 +443,22 @@ int CodeGen_X86::native_vector_bits() const {
     }
 }
 
+int CodeGen_X86::carried_value_registers() const {
+    // Use half the vector register file for carried values, and leave
+    // the rest for the computation.
+    int registers;
+    if (target.bits == 32) {
+        registers = 8;
+    } else if (native_vector_bits() == 512) {
+        registers = 32;
+    } else {
+        registers = 16;
+    }
+    return registers / 2;
+}
+
+bool CodeGen_X86::use_non_temporal_stores() const {
+    return true;
+}
+
 }}
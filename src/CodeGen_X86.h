@@ -28,6 +28,8 @@ protected:
     std::string mattrs() const;
     bool use_soft_float_abi() const;
     int native_vector_bits() const;
+    int carried_value_registers() const;
+    bool use_non_temporal_stores() const;
 
     Expr mulhi_shr(Expr a, Expr b, int shr);
 
@@ -989,9 +989,9 @@ void Stage::split(const string &old, const string &outer, const string &inner, E
     }
 
     if (exact) {
-        user_assert(tail == TailStrategy::GuardWithIf)
+        user_assert(tail == TailStrategy::GuardWithIf || tail == TailStrategy::Predicate)
             << "When splitting Var " << old_name
-            << " the tail strategy must be GuardWithIf or Auto. "
+            << " the tail strategy must be GuardWithIf, Predicate, or Auto. "
             << "Anything else may change the meaning of the algorithm\n";
     }
 
@@ -1719,14 +1719,16 @@ Stage &Stage::hexagon(VarOrRVar x) {
     return *this;
 }
 
-Stage &Stage::prefetch(const Func &f, VarOrRVar var, Expr offset, PrefetchBoundStrategy strategy) {
-    PrefetchDirective prefetch = {f.name(), var.name(), offset, strategy, Parameter()};
+Stage &Stage::prefetch(const Func &f, VarOrRVar var, Expr offset, PrefetchBoundStrategy strategy,
+                       PrefetchHint hint) {
+    PrefetchDirective prefetch = {f.name(), var.name(), offset, strategy, Parameter(), hint};
     definition.schedule().prefetches().push_back(prefetch);
     return *this;
 }
 
-Stage &Stage::prefetch(const Internal::Parameter &param, VarOrRVar var, Expr offset, PrefetchBoundStrategy strategy) {
-    PrefetchDirective prefetch = {param.name(), var.name(), offset, strategy, param};
+Stage &Stage::prefetch(const Internal::Parameter &param, VarOrRVar var, Expr offset, PrefetchBoundStrategy strategy,
+                       PrefetchHint hint) {
+    PrefetchDirective prefetch = {param.name(), var.name(), offset, strategy, param, hint};
     definition.schedule().prefetches().push_back(prefetch);
     return *this;
 }
@@ -1931,6 +1933,19 @@ Func &Func::memoize() {
     return *this;
 }
 
+Func &Func::store_persistent() {
+    invalidate_cache();
+    func.schedule().memoized() = true;
+    func.schedule().persistent() = true;
+    return *this;
+}
+
+Func &Func::store_non_temporal() {
+    invalidate_cache();
+    func.schedule().non_temporal_stores() = true;
+    return *this;
+}
+
 Stage Func::specialize(Expr c) {
     invalidate_cache();
     return Stage(func.definition(), name(), args(), func.schedule()).specialize(c);
@@ -2284,15 +2299,17 @@ Func &Func::hexagon(VarOrRVar x) {
     return *this;
 }
 
-Func &Func::prefetch(const Func &f, VarOrRVar var, Expr offset, PrefetchBoundStrategy strategy) {
+Func &Func::prefetch(const Func &f, VarOrRVar var, Expr offset, PrefetchBoundStrategy strategy,
+                     PrefetchHint hint) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).prefetch(f, var, offset, strategy);
+    Stage(func.definition(), name(), args(), func.schedule()).prefetch(f, var, offset, strategy, hint);
     return *this;
 }
 
-Func &Func::prefetch(const Internal::Parameter &param, VarOrRVar var, Expr offset, PrefetchBoundStrategy strategy) {
+Func &Func::prefetch(const Internal::Parameter &param, VarOrRVar var, Expr offset, PrefetchBoundStrategy strategy,
+                     PrefetchHint hint) {
     invalidate_cache();
-    Stage(func.definition(), name(), args(), func.schedule()).prefetch(param, var, offset, strategy);
+    Stage(func.definition(), name(), args(), func.schedule()).prefetch(param, var, offset, strategy, hint);
     return *this;
 }
 
@@ -288,13 +288,16 @@ public:
 
     EXPORT Stage &hexagon(VarOrRVar x = Var::outermost());
     EXPORT Stage &prefetch(const Func &f, VarOrRVar var, Expr offset = 1,
-                           PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf);
+                           PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                           PrefetchHint hint = PrefetchHint::Read);
     EXPORT Stage &prefetch(const Internal::Parameter &param, VarOrRVar var, Expr offset = 1,
-                           PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf);
+                           PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                           PrefetchHint hint = PrefetchHint::Read);
     template<typename T>
     Stage &prefetch(const T &image, VarOrRVar var, Expr offset = 1,
-                    PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf) {
-        return prefetch(image.parameter(), var, offset, strategy);
+                    PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                    PrefetchHint hint = PrefetchHint::Read) {
+        return prefetch(image.parameter(), var, offset, strategy, hint);
     }
     // @}
 };
@@ -1180,7 +1183,11 @@ public:
      *
      * Note that if the source Func is already valid in host memory,
      * this compiles to code that does the minimum number of calls to
-     * memcpy.
+     * memcpy. Combined with reorder_storage, this is also a fast way
+     * to express a change of memory layout (e.g. planar to
+     * interleaved, or a transpose), as dimensions that are
+     * contiguous in both source and destination are collapsed, and
+     * transposes are copied in cache-friendly tiles.
      */
     EXPORT Func copy_to_host();
 
@@ -1640,8 +1647,11 @@ public:
     /** Prefetch data written to or read from a Func or an ImageParam by a
      * subsequent loop iteration, at an optionally specified iteration offset.
      * 'var' specifies at which loop level the prefetch calls should be inserted.
-     * The final argument specifies how prefetch of region outside bounds
-     * should be handled.
+     * 'strategy' specifies how prefetch of region outside bounds should be
+     * handled, and 'hint' whether the data will be read or written, and
+     * whether it will be reused (see \ref PrefetchHint). The prefetched
+     * region may span many cache lines and rows; it is broken up into as
+     * many prefetch instructions as the target needs.
      *
      * For example, consider this pipeline:
      \code
@@ -1669,13 +1679,16 @@ public:
      */
     // @{
     EXPORT Func &prefetch(const Func &f, VarOrRVar var, Expr offset = 1,
-                          PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf);
+                          PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                          PrefetchHint hint = PrefetchHint::Read);
     EXPORT Func &prefetch(const Internal::Parameter &param, VarOrRVar var, Expr offset = 1,
-                          PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf);
+                          PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                          PrefetchHint hint = PrefetchHint::Read);
     template<typename T>
     Func &prefetch(const T &image, VarOrRVar var, Expr offset = 1,
-                   PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf) {
-        return prefetch(image.parameter(), var, offset, strategy);
+                   PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                   PrefetchHint hint = PrefetchHint::Read) {
+        return prefetch(image.parameter(), var, offset, strategy, hint);
     }
     // @}
 
@@ -1869,9 +1882,49 @@ public:
     /** Use the halide_memoization_cache_... interface to store a
      *  computed version of this function across invocations of the
      *  Func.
+     *
+     *  The cache key includes the region computed, so a Func
+     *  computed at an inner loop level is cached tile by tile, and
+     *  later invocations that compute some of the same tiles reuse
+     *  them. Pipeline outputs, and Funcs stored at a different loop
+     *  level than they are computed at, can also be memoized. Their
+     *  storage can't come from the cache, so each computed region is
+     *  copied out of the cache on a hit, and into it on a miss.
      */
     EXPORT Func &memoize();
 
+    /** Keep the values of this function computed by one invocation of
+     * the pipeline around for use by later invocations, even though
+     * it depends on input buffers. This is memoize(), except that the
+     * input buffers are not part of the cache key: their contents at
+     * a given coordinate are assumed never to change. This is the
+     * case for a video indexed by absolute frame number, where each
+     * invocation binds a window of frames ending at the newest one.
+     *
+     * The cache key includes the region computed, so schedule the
+     * function compute_at a loop over frames. Each frame is then
+     * looked up on its own, and a temporal filter over the last N
+     * frames only computes the newest frame per invocation instead
+     * of all N. Cached frames count against the memoization cache
+     * size (see halide_memoization_cache_set_size), which should be
+     * large enough to hold a window's worth of frames.
+     */
+    EXPORT Func &store_persistent();
+
+    /** Write the values of this function to memory without bringing
+     * them into the cache, on targets that support it (currently
+     * x86). This is worthwhile for large outputs that the pipeline
+     * writes once and never reads back, such as a final frame that
+     * is much larger than the last-level cache: it avoids both
+     * evicting useful data and reading each line in before
+     * overwriting it. Only dense vector stores are affected, and
+     * only when the buffer is aligned to the vector width (see
+     * \ref OutputImageParam::set_host_alignment for outputs). Don't
+     * use it for functions that are read soon after they are
+     * computed, or that have update definitions. The auto-scheduler
+     * sets this on outputs larger than the last-level cache. */
+    EXPORT Func &store_non_temporal();
+
 
     /** Allocate storage for this function within f's loop over
      * var. Scheduling storage is optional, and can be used to
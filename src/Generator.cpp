@@ -5,6 +5,7 @@
 #include "Generator.h"
 #include "Outputs.h"
 #include "Simplify.h"
+#include "WrapExternStages.h"
 
 namespace Halide {
 namespace Internal {
@@ -86,6 +87,9 @@ Outputs compute_outputs(const Target &target,
     if (options.emit_stmt_html) {
         output_files.stmt_html_name = base_path + get_extension(".html", options);
     }
+    if (options.emit_python_extension) {
+        output_files.python_extension_name = base_path + get_extension(".py.cpp", options);
+    }
     if (options.emit_static_library) {
         if (is_windows_coff) {
             output_files.static_library_name = base_path + get_extension(".lib", options);
@@ -190,6 +194,14 @@ std::vector<Type> parse_halide_type_list(const std::string &types) {
     return result;
 }
 
+std::vector<int> parse_int_list(const std::string &values) {
+    std::vector<int> result;
+    for (auto v : split_string(values, ",")) {
+        result.push_back(parse_scalar<int>(v));
+    }
+    return result;
+}
+
 void ValueTracker::track_values(const std::string &name, const std::vector<Expr> &values) {
     std::vector<std::vector<Expr>> &history = values_history[name];
     if (history.empty()) {
@@ -297,6 +309,7 @@ private:
         std::vector<Internal::GeneratorParamBase *> out;
         for (auto p : in) {
             if (p->name == "target") continue;
+            if (p->name == "batch_entry_point") continue;
             if (p->is_synthetic_param()) continue;
             out.push_back(p);
         }
@@ -791,7 +804,7 @@ int generate_filter_main(int argc, char **argv, std::ostream &cerr) {
     const char kUsage[] = "gengen [-g GENERATOR_NAME] [-f FUNCTION_NAME] [-o OUTPUT_DIR] [-r RUNTIME_NAME] [-e EMIT_OPTIONS] [-x EXTENSION_OPTIONS] [-n FILE_BASE_NAME] "
                           "target=target-string[,target-string...] [generator_arg=value [...]]\n\n"
                           "  -e  A comma separated list of files to emit. Accepted values are "
-                          "[assembly, bitcode, cpp, h, html, o, static_library, stmt, cpp_stub]. If omitted, default value is [static_library, h].\n"
+                          "[assembly, bitcode, cpp, h, html, o, static_library, stmt, cpp_stub, python_extension]. If omitted, default value is [static_library, h].\n"
                           "  -x  A comma separated list of file extension pairs to substitute during file naming, "
                           "in the form [.old=.new[,.old2=.new2]]\n";
 
@@ -906,9 +919,11 @@ int generate_filter_main(int argc, char **argv, std::ostream &cerr) {
                 emit_options.emit_static_library = true;
             } else if (opt == "cpp_stub") {
                 emit_options.emit_cpp_stub = true;
+            } else if (opt == "python_extension") {
+                emit_options.emit_python_extension = true;
             } else if (!opt.empty()) {
                 cerr << "Unrecognized emit option: " << opt
-                     << " not one of [assembly, bitcode, cpp, h, html, o, static_library, stmt, cpp_stub], ignoring.\n";
+                     << " not one of [assembly, bitcode, cpp, h, html, o, static_library, stmt, cpp_stub, python_extension], ignoring.\n";
             }
         }
     }
@@ -1112,6 +1127,13 @@ GeneratorBase::ParamInfo::ParamInfo(GeneratorBase *generator, const size_t size)
         input->generator = generator;
         filter_inputs.push_back(input);
         add_synthetic_params(input);
+        if (input->kind() == IOKind::Buffer) {
+            const std::string &n = input->name();
+            owned_synthetic_params.emplace_back(new GeneratorParam_Synthetic<int>(n + ".extents", *input, GeneratorParam_Synthetic<int>::Extents));
+            generator_params.push_back(owned_synthetic_params.back().get());
+            owned_synthetic_params.emplace_back(new GeneratorParam_Synthetic<int>(n + ".strides", *input, GeneratorParam_Synthetic<int>::Strides));
+            generator_params.push_back(owned_synthetic_params.back().get());
+        }
     }
 
     std::vector<void *> vo = ObjectInstanceRegistry::instances_in_range(
@@ -1439,6 +1461,28 @@ Module GeneratorBase::build_module(const std::string &function_name,
     }
 
     Module result = pipeline.compile_to_module(filter_arguments, function_name, target, linkage_type);
+    if (batch_entry_point) {
+        // The pipeline itself is always the first externally-visible
+        // function in the module.
+        size_t i = 0;
+        while (result.functions()[i].linkage == LoweredFunc::Internal) {
+            i++;
+        }
+        const LoweredFunc f = result.functions()[i];
+
+        // The batch wrapper checks the arguments once, then runs the
+        // remaining items through a copy of the pipeline lowered
+        // without the checks on its arguments. Only lowering drops
+        // them: the module is still compiled with asserts, so errors
+        // from within the pipeline are still reported.
+        Module unchecked = pipeline.compile_to_module(filter_arguments, f.name + "_unchecked",
+                                                      get_target().with_feature(Target::NoAsserts),
+                                                      LoweredFunc::Internal);
+        for (const auto &uf : unchecked.functions()) {
+            result.append(uf);
+        }
+        add_batch_wrapper(result, f, unchecked.get_function_by_name(f.name + "_unchecked"));
+    }
     std::shared_ptr<ExternsMap> externs_map = get_externs_map();
     for (const auto &map_entry : *externs_map) {
         result.append(map_entry.second);
@@ -1641,9 +1685,19 @@ void GeneratorInputBase::set_def_min_max() {
 }
 
 void GeneratorInputBase::init_parameters() {
+    user_assert((int)specialized_extents_.size() <= dims() && (int)specialized_strides_.size() <= dims())
+        << "Input " << name() << " has " << dims() << " dimensions, but "
+        << specialized_extents_.size() << " extents and " << specialized_strides_.size()
+        << " strides were given.\n";
     parameters_.clear();
     for (size_t i = 0; i < array_size(); ++i) {
         parameters_.emplace_back(type(), kind() != IOKind::Scalar, dims(), array_name(i), true, false);
+        for (size_t d = 0; d < specialized_extents_.size(); d++) {
+            parameters_.back().set_extent_specialization(d, specialized_extents_[d]);
+        }
+        for (size_t d = 0; d < specialized_strides_.size(); d++) {
+            parameters_.back().set_stride_specialization(d, specialized_strides_[d]);
+        }
     }
     set_def_min_max();
 }
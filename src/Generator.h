@@ -1154,6 +1154,11 @@ protected:
     std::vector<Type> types_;  // empty if type is unspecified
     int dims_;           // -1 if dim is unspecified
 
+    // Expected extents and strides of the leading dimensions of a
+    // buffer Input, which the pipeline is specialized on. Empty if
+    // none were given.
+    std::vector<int> specialized_extents_, specialized_strides_;
+
     // Exactly one of these will have nonzero length
     std::vector<Func> funcs_;
     std::vector<Expr> exprs_;
@@ -2147,6 +2152,8 @@ T parse_scalar(const std::string &value) {
 
 EXPORT std::vector<Type> parse_halide_type_list(const std::string &types);
 
+EXPORT std::vector<int> parse_int_list(const std::string &values);
+
 // This is a type of GeneratorParam used internally to create 'synthetic' params
 // (e.g. image.type, image.dim); it is not possible for user code to instantiate it.
 template<typename T>
@@ -2178,7 +2185,7 @@ public:
 private:
     friend class GeneratorBase;
 
-    enum Which { Type, Dim, ArraySize };
+    enum Which { Type, Dim, ArraySize, Extents, Strides };
     GeneratorParam_Synthetic(const std::string &name, GIOBase &gio, Which which) : GeneratorParamImpl<T>(name, T()), gio(gio), which(which) {}
 
     template <typename T2 = T, typename std::enable_if<std::is_same<T2, ::Halide::Type>::value>::type * = nullptr>
@@ -2193,6 +2200,10 @@ private:
             gio.dims_ = parse_scalar<T2>(new_value_string);
         } else if (which == ArraySize) {
             gio.array_size_ = parse_scalar<T2>(new_value_string);
+        } else if (which == Extents) {
+            gio.specialized_extents_ = parse_int_list(new_value_string);
+        } else if (which == Strides) {
+            gio.specialized_strides_ = parse_int_list(new_value_string);
         } else {
             internal_error;
         }
@@ -2364,7 +2375,7 @@ using GeneratorFactory = std::function<std::unique_ptr<GeneratorBase>(const Gene
 class GeneratorBase : public NamesInterface, public GeneratorContext {
 public:
     struct EmitOptions {
-        bool emit_o, emit_h, emit_cpp, emit_assembly, emit_bitcode, emit_stmt, emit_stmt_html, emit_static_library, emit_cpp_stub;
+        bool emit_o, emit_h, emit_cpp, emit_assembly, emit_bitcode, emit_stmt, emit_stmt_html, emit_static_library, emit_cpp_stub, emit_python_extension;
         // This is an optional map used to replace the default extensions generated for
         // a file: if an key matches an output extension, emit those files with the
         // corresponding value instead (e.g., ".s" -> ".assembly_text"). This is
@@ -2374,7 +2385,8 @@ public:
         std::map<std::string, std::string> substitutions;
         EmitOptions()
             : emit_o(false), emit_h(true), emit_cpp(false), emit_assembly(false),
-              emit_bitcode(false), emit_stmt(false), emit_stmt_html(false), emit_static_library(true), emit_cpp_stub(false) {}
+              emit_bitcode(false), emit_stmt(false), emit_stmt_html(false), emit_static_library(true), emit_cpp_stub(false),
+              emit_python_extension(false) {}
     };
 
     EXPORT virtual ~GeneratorBase();
@@ -2482,6 +2494,17 @@ protected:
     EXPORT void pre_schedule();
     EXPORT void post_schedule();
 
+    /** If true, build_module() also produces an entry point named
+     * <function_name>_batch whose buffer arguments have one extra
+     * outermost dimension. It checks once that all buffers agree on
+     * the bounds of that dimension, and runs the pipeline on the
+     * first slice of it with the usual checks on its arguments. The
+     * other slices have the same shape, so they are run in parallel
+     * through a copy of the pipeline without those checks. Settable
+     * like any other GeneratorParam (e.g. batch_entry_point=true on
+     * the command line). */
+    GeneratorParam<bool> batch_entry_point{"batch_entry_point", false};
+
     template<typename T>
     using Input = GeneratorInput<T>;
 
@@ -634,7 +634,8 @@ Stmt Realize::make(const std::string &name, const std::vector<Type> &types, cons
     return node;
 }
 
-Stmt Prefetch::make(const std::string &name, const std::vector<Type> &types, const Region &bounds, Parameter param) {
+Stmt Prefetch::make(const std::string &name, const std::vector<Type> &types, const Region &bounds,
+                    Parameter param, PrefetchHint hint) {
     for (size_t i = 0; i < bounds.size(); i++) {
         internal_assert(bounds[i].min.defined()) << "Prefetch of undefined\n";
         internal_assert(bounds[i].extent.defined()) << "Prefetch of undefined\n";
@@ -648,6 +649,7 @@ Stmt Prefetch::make(const std::string &name, const std::vector<Type> &types, con
     node->types = types;
     node->bounds = bounds;
     node->param = std::move(param);
+    node->hint = hint;
     return node;
 }
 
@@ -713,8 +715,8 @@ Expr Call::make(Type type, const std::string &name, const std::vector<Expr> &arg
                 FunctionPtr func, int value_index,
                 Buffer<> image, Parameter param) {
     if (name == Call::prefetch && call_type == Call::Intrinsic) {
-        internal_assert(args.size() % 2 == 0)
-            << "Number of args to a prefetch call should be even: {base, offset, extent0, min0, ...}\n";
+        internal_assert(args.size() % 2 == 1)
+            << "Number of args to a prefetch call should be odd: {base, offset, extent0, stride0, ..., hint}\n";
     }
     for (size_t i = 0; i < args.size(); i++) {
         internal_assert(args[i].defined()) << "Call of undefined\n";
@@ -986,6 +988,7 @@ Call::ConstString Call::div_round_to_zero = "div_round_to_zero";
 Call::ConstString Call::mod_round_to_zero = "mod_round_to_zero";
 Call::ConstString Call::call_cached_indirect_function = "call_cached_indirect_function";
 Call::ConstString Call::prefetch = "prefetch";
+Call::ConstString Call::non_temporal_fence = "non_temporal_fence";
 Call::ConstString Call::signed_integer_overflow = "signed_integer_overflow";
 Call::ConstString Call::indeterminate_expression = "indeterminate_expression";
 Call::ConstString Call::bool_to_mask = "bool_to_mask";
@@ -514,6 +514,7 @@ struct Call : public ExprNode<Call> {
         mod_round_to_zero,
         call_cached_indirect_function,
         prefetch,
+        non_temporal_fence,
         signed_integer_overflow,
         indeterminate_expression,
         bool_to_mask,
@@ -743,8 +744,12 @@ struct Prefetch : public StmtNode<Prefetch> {
     /** If it's a prefetch load from an image parameter, this points to that. */
     Parameter param;
 
+    /** How the prefetched data will be used. */
+    PrefetchHint hint;
+
     EXPORT static Stmt make(const std::string &name, const std::vector<Type> &types,
-                            const Region &bounds, Parameter param = Parameter());
+                            const Region &bounds, Parameter param = Parameter(),
+                            PrefetchHint hint = PrefetchHint::Read);
 
     static const IRNodeType _node_type = IRNodeType::Prefetch;
 };
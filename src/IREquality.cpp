@@ -455,6 +455,7 @@ void IRComparer::visit(const Prefetch *op) {
     const Prefetch *s = expr.as<Prefetch>();
 
     compare_names(s->name, op->name);
+    compare_scalar(s->hint, op->hint);
     compare_scalar(s->bounds.size(), op->bounds.size());
     for (size_t i = 0; (result == Equal) && (i < s->bounds.size()); i++) {
         compare_expr(s->bounds[i].min, op->bounds[i].min);
@@ -320,7 +320,7 @@ void IRMutator::visit(const Prefetch *op) {
     if (!bounds_changed) {
         stmt = op;
     } else {
-        stmt = Prefetch::make(op->name, op->types, new_bounds, op->param);
+        stmt = Prefetch::make(op->name, op->types, new_bounds, op->param, op->hint);
     }
 }
 
@@ -678,7 +678,21 @@ void IRPrinter::visit(const Prefetch *op) {
         stream << "]";
         if (i < op->bounds.size() - 1) stream << ", ";
     }
-    stream << ")\n";
+    stream << ")";
+    switch (op->hint) {
+    case PrefetchHint::Read:
+        break;
+    case PrefetchHint::Write:
+        stream << " for write";
+        break;
+    case PrefetchHint::ReadNonTemporal:
+        stream << " non-temporal";
+        break;
+    case PrefetchHint::WriteNonTemporal:
+        stream << " for write non-temporal";
+        break;
+    }
+    stream << "\n";
 }
 
 void IRPrinter::visit(const Block *op) {
@@ -0,0 +1,268 @@
+#include "InvariantDivision.h"
+#include "ExprUsesVar.h"
+#include "IREquality.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "Scope.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace {
+
+bool is_device_loop(const For *op) {
+    return (op->device_api != DeviceAPI::None &&
+            op->device_api != DeviceAPI::Host);
+}
+
+// Find the names of everything defined inside a loop.
+class FindDefinitions : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Let *op) {
+        defined.push(op->name, 0);
+        IRVisitor::visit(op);
+    }
+
+    void visit(const LetStmt *op) {
+        defined.push(op->name, 0);
+        IRVisitor::visit(op);
+    }
+
+    void visit(const For *op) {
+        defined.push(op->name, 0);
+        IRVisitor::visit(op);
+    }
+
+public:
+    Scope<int> defined;
+};
+
+// Check if an expression can be evaluated outside the loop it
+// appears in, provided none of the variables it refers to are
+// defined inside that loop.
+class CanHoist : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Load *op) {
+        result = false;
+    }
+
+    void visit(const Call *op) {
+        if (!op->is_pure()) {
+            result = false;
+        }
+        IRVisitor::visit(op);
+    }
+
+public:
+    bool result = true;
+};
+
+// The names of the values computed outside the loop for one divisor.
+struct InvariantDivisor {
+    Expr divisor;
+    string name;
+
+    Type type() const {
+        return divisor.type();
+    }
+
+    Type unsigned_type() const {
+        return type().with_code(Type::UInt);
+    }
+
+    Expr var(const string &suffix, Type t, int lanes) const {
+        return Broadcast::make(Variable::make(t, name + suffix), lanes);
+    }
+
+    // The lets to wrap around the loop, from the outside in.
+    vector<pair<string, Expr>> lets() const {
+        // Round-up multiply-high division, from Granlund and
+        // Montgomery. For a divisor d with l = ceil(log2(d)):
+        //   m = floor(2^N * (2^l - d) / d) + 1
+        //   t = mulhi(m, n)
+        //   n / d = (t + ((n - t) >> min(l, 1))) >> max(l - 1, 0)
+        // This works for every unsigned N-bit divisor, including one,
+        // without an overflowing add. A divisor of zero gives
+        // meaningless values, but nothing traps.
+        Type ut = unsigned_type();
+        int bits = ut.bits();
+        vector<pair<string, Expr>> result;
+        Expr d = divisor;
+        if (type().is_int()) {
+            result.push_back({name + ".sign", d >> (bits - 1)});
+            d = abs(d);
+        }
+        result.push_back({name + ".abs", d});
+        d = Variable::make(ut, name + ".abs");
+
+        Expr l = make_const(ut, bits) - count_leading_zeros(d - 1);
+        result.push_back({name + ".log2", l});
+        l = Variable::make(ut, name + ".log2");
+
+        Expr wide_d = cast(UInt(64), max(d, 1));
+        Expr m = (((make_const(UInt(64), 1) << cast(UInt(64), l)) - wide_d) << bits) / wide_d + 1;
+        result.push_back({name + ".multiplier", cast(ut, m)});
+        result.push_back({name + ".shift1", min(l, 1)});
+        result.push_back({name + ".shift2", max(l, 1) - 1});
+        return result;
+    }
+
+    // Divide a vector of unsigned values by the absolute value of
+    // the divisor.
+    Expr unsigned_divide(Expr n) const {
+        Type ut = n.type();
+        Type wide = ut.with_bits(ut.bits() * 2);
+        int lanes = n.type().lanes();
+        Expr m = var(".multiplier", ut.element_of(), lanes);
+        Expr t = cast(ut, (cast(wide, n) * cast(wide, m)) >> ut.bits());
+        return (t + ((n - t) >> var(".shift1", ut.element_of(), lanes))) >>
+            var(".shift2", ut.element_of(), lanes);
+    }
+
+    // Rewrite n / divisor or n % divisor.
+    Expr divide(Expr n, bool is_mod) const {
+        Type t = n.type();
+        Type ut = t.with_code(Type::UInt);
+        int lanes = t.lanes();
+        if (t.is_uint()) {
+            Expr q = unsigned_divide(n);
+            return is_mod ? n - q * var(".abs", ut.element_of(), lanes) : q;
+        }
+
+        // Round towards negative infinity by dividing ~n instead of
+        // n when n is negative, as codegen does for constant
+        // divisors, then negate the result for a negative divisor.
+        Expr n_sign = n >> (t.bits() - 1);
+        Expr q = unsigned_divide(reinterpret(ut, n ^ n_sign));
+        q = reinterpret(t, q) ^ n_sign;
+        if (is_mod) {
+            // The remainder only depends on the magnitude of the
+            // divisor. Compute it without signed overflow.
+            Expr r = (reinterpret(ut, n) -
+                      reinterpret(ut, q) * var(".abs", ut.element_of(), lanes));
+            return reinterpret(t, r);
+        } else {
+            Expr d_sign = var(".sign", t.element_of(), lanes);
+            return (q ^ d_sign) - d_sign;
+        }
+    }
+};
+
+// Rewrite the divisions in a loop body whose divisor is invariant in
+// that loop.
+class RewriteDivisions : public IRMutator {
+    using IRMutator::visit;
+
+    const Scope<int> &defined;
+
+    const InvariantDivisor *find_divisor(Expr b, Type t) {
+        if (!t.is_vector() ||
+            !(t.is_int() || t.is_uint()) ||
+            !(t.bits() == 8 || t.bits() == 16 || t.bits() == 32)) {
+            return nullptr;
+        }
+        const Broadcast *broadcast = b.as<Broadcast>();
+        if (!broadcast || is_const(broadcast->value)) {
+            return nullptr;
+        }
+        Expr d = broadcast->value;
+        CanHoist check;
+        d.accept(&check);
+        if (!check.result || expr_uses_vars(d, defined)) {
+            return nullptr;
+        }
+        for (const InvariantDivisor &existing : divisors) {
+            if (equal(existing.divisor, d)) {
+                return &existing;
+            }
+        }
+        divisors.push_back({d, unique_name('d')});
+        return &divisors.back();
+    }
+
+    template<typename T>
+    Expr visit_div_or_mod(const T *op, bool is_mod) {
+        Expr a = mutate(op->a);
+        const InvariantDivisor *d = find_divisor(op->b, op->type);
+        if (!d) {
+            Expr b = mutate(op->b);
+            if (a.same_as(op->a) && b.same_as(op->b)) {
+                return op;
+            }
+            return T::make(a, b);
+        }
+        debug(3) << "Strength-reducing " << Expr(op) << "\n";
+        // The numerator is used more than once.
+        string n_name = unique_name('t');
+        Expr n = Variable::make(a.type(), n_name);
+        return Let::make(n_name, a, d->divide(n, is_mod));
+    }
+
+    void visit(const Div *op) {
+        expr = visit_div_or_mod(op, false);
+    }
+
+    void visit(const Mod *op) {
+        expr = visit_div_or_mod(op, true);
+    }
+
+    void visit(const For *op) {
+        if (is_device_loop(op)) {
+            stmt = op;
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+public:
+    vector<InvariantDivisor> divisors;
+
+    RewriteDivisions(const Scope<int> &defined) : defined(defined) {}
+};
+
+class ReduceInvariantDivisions : public IRMutator {
+    using IRMutator::visit;
+
+    void visit(const For *op) {
+        if (is_device_loop(op)) {
+            stmt = op;
+            return;
+        }
+
+        // Rewrite the divisions that are invariant in this loop
+        // first, so that their setup lands as far out as possible,
+        // then look for ones that are only invariant in inner loops.
+        FindDefinitions defs;
+        defs.defined.push(op->name, 0);
+        op->body.accept(&defs);
+        RewriteDivisions rewriter(defs.defined);
+        Stmt body = mutate(rewriter.mutate(op->body));
+
+        if (body.same_as(op->body)) {
+            stmt = op;
+            return;
+        }
+        stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body);
+        for (size_t i = rewriter.divisors.size(); i > 0; i--) {
+            vector<pair<string, Expr>> lets = rewriter.divisors[i - 1].lets();
+            for (size_t j = lets.size(); j > 0; j--) {
+                stmt = LetStmt::make(lets[j - 1].first, lets[j - 1].second, stmt);
+            }
+        }
+    }
+};
+
+}  // namespace
+
+Stmt strength_reduce_invariant_divisions(Stmt s) {
+    return ReduceInvariantDivisions().mutate(s);
+}
+
+}
+}
@@ -0,0 +1,27 @@
+#ifndef HALIDE_INVARIANT_DIVISION_H
+#define HALIDE_INVARIANT_DIVISION_H
+
+/** \file
+ * Defines the lowering pass that strength-reduces vector division by
+ * loop-invariant runtime divisors.
+ */
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Find vector divisions and modulos of 8, 16, and 32-bit integers
+ * whose divisor is a broadcast of a value that doesn't vary within an
+ * enclosing loop, but isn't known at compile time. Compute a magic
+ * multiplier and shifts for the divisor once outside the outermost
+ * such loop, and replace the division inside it with a multiply-high
+ * sequence. Preserves Halide's Euclidean semantics for signed
+ * types. Constant divisors are left alone, because codegen already
+ * handles them. Must be called after vectorization. */
+Stmt strength_reduce_invariant_divisions(Stmt s);
+
+}
+}
+
+#endif
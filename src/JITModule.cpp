@@ -276,7 +276,10 @@ void JITModule::compile_module(std::unique_ptr<llvm::Module> m, const string &fu
     HalideJITMemoryManager *memory_manager = new HalideJITMemoryManager(dependencies);
     engine_builder.setMCJITMemoryManager(std::unique_ptr<RTDyldMemoryManager>(memory_manager));
 
-    engine_builder.setOptLevel(CodeGenOpt::Aggressive);
+    // With no optimization, LLVM uses FastISel for instruction
+    // selection, which is much faster than the default selector.
+    engine_builder.setOptLevel(target.has_feature(Target::FastCompile) ?
+                               CodeGenOpt::None : CodeGenOpt::Aggressive);
     if (!mcpu.empty()) {
         engine_builder.setMCPU(mcpu);
     }
@@ -639,6 +642,10 @@ JITModule &make_module(llvm::Module *for_module, Target target,
         // order for the right runtime components to be added.
         target.set_feature(Target::JIT);
 
+        // The shared runtime outlives the module that caused it to be
+        // made, so always compile it properly.
+        target.set_feature(Target::FastCompile, false);
+
         Target one_gpu(target);
         one_gpu.set_feature(Target::OpenCL, false);
         one_gpu.set_feature(Target::Metal, false);
@@ -191,7 +191,7 @@ class LoopCarryOverLoop : public IRMutator {
     // to lift out.
     const Scope<int> &in_consume;
 
-    int max_carried_values;
+    int max_carried_values, register_bits;
 
     using IRMutator::visit;
 
@@ -225,22 +225,35 @@ class LoopCarryOverLoop : public IRMutator {
 
         vector<Stmt> stores;
         vector<Stmt> result;
+        bool changed = false;
+        auto lift_stores = [&]() {
+            Stmt orig = Block::make(stores);
+            Stmt lifted = lift_carried_values_out_of_stmt(orig);
+            changed = changed || !lifted.same_as(orig);
+            result.push_back(lifted);
+            stores.clear();
+        };
         for (size_t i = 0; i < v.size(); i++) {
             if (v[i].as<Store>()) {
                 stores.push_back(v[i]);
             } else {
                 if (!stores.empty()) {
-                    result.push_back(lift_carried_values_out_of_stmt(Block::make(stores)));
-                    stores.clear();
+                    lift_stores();
                 }
-                result.push_back(mutate(v[i]));
+                Stmt s = mutate(v[i]);
+                changed = changed || !s.same_as(v[i]);
+                result.push_back(s);
             }
         }
         if (!stores.empty()) {
-            result.push_back(lift_carried_values_out_of_stmt(Block::make(stores)));
+            lift_stores();
         }
 
-        stmt = Block::make(result);
+        if (changed) {
+            stmt = Block::make(result);
+        } else {
+            stmt = op;
+        }
     }
 
     Stmt lift_carried_values_out_of_stmt(Stmt orig_stmt) {
@@ -347,24 +360,43 @@ class LoopCarryOverLoop : public IRMutator {
             }
         }
 
-        // Only keep the top N carried values. Otherwise we'll just
-        // spray stack spills everywhere. This is ugly, because we're
-        // relying on a heuristic.
+        // Only keep as many carried values as fit in the register
+        // budget. Otherwise we'll just spray stack spills
+        // everywhere. This is ugly, because we're relying on a
+        // heuristic.
+        auto registers_needed = [&](int i) {
+            if (register_bits <= 0) {
+                return 1;
+            }
+            Type t = loads[i][0]->type;
+            return std::max(1, (t.bits() * t.lanes() + register_bits - 1) / register_bits);
+        };
         vector<vector<int>> trimmed;
-        size_t sz = 0;
+        int used = 0;
         for (const vector<int> &c : chains) {
-            if (sz + c.size() > (size_t)max_carried_values) {
-                if (sz < (size_t)max_carried_values - 1) {
-                    // Take a partial chain
-                    trimmed.emplace_back(c.begin(), c.begin() + max_carried_values - sz);
+            vector<int> kept;
+            for (int i : c) {
+                if (used + registers_needed(i) > max_carried_values) {
+                    break;
                 }
+                kept.push_back(i);
+                used += registers_needed(i);
+            }
+            if (kept.size() > 1) {
+                // Take a (possibly partial) chain. A chain of one
+                // value carries nothing.
+                trimmed.push_back(kept);
+            }
+            if (kept.size() < c.size()) {
                 break;
             }
-            trimmed.push_back(c);
-            sz += c.size();
         }
         chains.swap(trimmed);
 
+        if (chains.empty()) {
+            return orig_stmt;
+        }
+
         // We now have chains of the form:
         // f[x] <- f[x+1] <- ... <- f[x+N-1]
 
@@ -480,8 +512,8 @@ class LoopCarryOverLoop : public IRMutator {
     }
 
 public:
-    LoopCarryOverLoop(const string &var, const Scope<int> &s, int max_carried_values)
-        : in_consume(s), max_carried_values(max_carried_values) {
+    LoopCarryOverLoop(const string &var, const Scope<int> &s, int max_carried_values, int register_bits)
+        : in_consume(s), max_carried_values(max_carried_values), register_bits(register_bits) {
         linear.push(var, 1);
     }
 
@@ -498,7 +530,7 @@ public:
 class LoopCarry : public IRMutator {
     using IRMutator::visit;
 
-    int max_carried_values;
+    int max_carried_values, register_bits;
     Scope<int> in_consume;
 
     void visit(const ProducerConsumer *op) {
@@ -508,14 +540,23 @@ class LoopCarry : public IRMutator {
             in_consume.push(op->name, 0);
             Stmt body = mutate(op->body);
             in_consume.pop(op->name);
-            stmt = ProducerConsumer::make(op->name, op->is_producer, body);
+            if (body.same_as(op->body)) {
+                stmt = op;
+            } else {
+                stmt = ProducerConsumer::make(op->name, op->is_producer, body);
+            }
         }
     }
 
     void visit(const For *op) {
-        if (op->for_type == ForType::Serial && !is_one(op->extent)) {
+        if (op->device_api != DeviceAPI::None &&
+            op->device_api != DeviceAPI::Host &&
+            op->device_api != DeviceAPI::Hexagon) {
+            // Leave code for other devices alone.
+            stmt = op;
+        } else if (op->for_type == ForType::Serial && !is_one(op->extent)) {
             Stmt body = mutate(op->body);
-            LoopCarryOverLoop carry(op->name, in_consume, max_carried_values);
+            LoopCarryOverLoop carry(op->name, in_consume, max_carried_values, register_bits);
             body = carry.mutate(body);
             if (body.same_as(op->body)) {
                 stmt = op;
@@ -538,14 +579,15 @@ class LoopCarry : public IRMutator {
     }
 
 public:
-    LoopCarry(int max_carried_values) : max_carried_values(max_carried_values) {}
+    LoopCarry(int max_carried_values, int register_bits)
+        : max_carried_values(max_carried_values), register_bits(register_bits) {}
 };
 
 }
 
 
-Stmt loop_carry(Stmt s, int max_carried_values) {
-    s = LoopCarry(max_carried_values).mutate(s);
+Stmt loop_carry(Stmt s, int max_carried_values, int register_bits) {
+    s = LoopCarry(max_carried_values, register_bits).mutate(s);
     return s;
 }
 
@@ -10,9 +10,13 @@ namespace Internal {
  * induction variables instead of redoing the load. If the loads are
  * predicated, the predicates need to match. Can be an optimization or
  * pessimization depending on how good the L1 cache is on the architecture
- * and how many memory issue slots there are. Currently only intended
- * for Hexagon. */
-Stmt loop_carry(Stmt, int max_carried_values = 8);
+ * and how many memory issue slots there are.
+ *
+ * At most max_carried_values values are carried per loop. If
+ * register_bits is non-zero, max_carried_values is instead a budget
+ * of registers of that many bits, and values wider than one register
+ * count as several. */
+Stmt loop_carry(Stmt, int max_carried_values = 8, int register_bits = 0);
 
 }
 }
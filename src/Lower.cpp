@@ -27,12 +27,16 @@
 #include "InjectHostDevBufferCopies.h"
 #include "InjectOpenGLIntrinsics.h"
 #include "Inline.h"
+#include "InvariantDivision.h"
 #include "IRMutator.h"
 #include "IROperator.h"
 #include "IRPrinter.h"
 #include "LICM.h"
 #include "LoopCarry.h"
 #include "Memoization.h"
+#include "MemoryPlanning.h"
+#include "NarrowArithmetic.h"
+#include "NonTemporalStores.h"
 #include "PartitionLoops.h"
 #include "Prefetch.h"
 #include "Profiling.h"
@@ -45,6 +49,7 @@
 #include "SelectGPUAPI.h"
 #include "SkipStages.h"
 #include "SlidingWindow.h"
+#include "SpecializeBufferShapes.h"
 #include "Simplify.h"
 #include "SimplifySpecializations.h"
 #include "SplitTuples.h"
@@ -218,6 +223,12 @@ Module lower(const vector<Function> &output_funcs, const string &pipeline_name,
     s = remove_undef(s);
     debug(2) << "Lowering after removing code that depends on undef values:\n" << s << "\n\n";
 
+    if (!compile_to_tiramisu) {
+        debug(1) << "Specializing on expected buffer shapes...\n";
+        s = specialize_buffer_shapes(s);
+        debug(2) << "Lowering after specializing on expected buffer shapes:\n" << s << "\n\n";
+    }
+
     // This uniquifies the variable names, so we're good to simplify
     // after this point. This lets later passes assume syntactic
     // equivalence means semantic equivalence.
@@ -243,7 +254,7 @@ Module lower(const vector<Function> &output_funcs, const string &pipeline_name,
 
     if (!compile_to_tiramisu) {
         debug(1) << "Injecting prefetches...\n";
-        s = inject_prefetch(s, env);
+        s = inject_prefetch(s, env, t);
         debug(2) << "Lowering after injecting prefetches:\n" << s << "\n\n";
 
         debug(1) << "Dynamically skipping stages...\n";
@@ -318,7 +329,7 @@ Module lower(const vector<Function> &output_funcs, const string &pipeline_name,
         debug(2) << "Lowering after unrolling:\n" << s << "\n\n";
 
         debug(1) << "Vectorizing...\n";
-        s = vectorize_loops(s, t);
+        s = vectorize_loops(s, env, t);
         s = simplify(s);
         debug(2) << "Lowering after vectorizing:\n" << s << "\n\n";
 
@@ -336,10 +347,31 @@ Module lower(const vector<Function> &output_funcs, const string &pipeline_name,
         s = trim_no_ops(s);
         debug(2) << "Lowering after loop trimming:\n" << s << "\n\n";
 
+        if (t.has_feature(Target::NarrowArithmetic)) {
+            debug(1) << "Narrowing vector arithmetic...\n";
+            s = narrow_arithmetic(s);
+            s = simplify(s);
+            debug(2) << "Lowering after narrowing vector arithmetic:\n" << s << "\n\n";
+        }
+
+        debug(1) << "Strength-reducing division by loop-invariant divisors...\n";
+        s = strength_reduce_invariant_divisions(s);
+        debug(2) << "Lowering after strength-reducing loop-invariant division:\n" << s << "\n\n";
+
         debug(1) << "Injecting early frees...\n";
         s = inject_early_frees(s);
         debug(2) << "Lowering after injecting early frees:\n" << s << "\n\n";
 
+        if (t.has_feature(Target::MemoryPlanning)) {
+            debug(1) << "Planning memory...\n";
+            s = plan_memory(s, t);
+            debug(2) << "Lowering after planning memory:\n" << s << "\n\n";
+        }
+
+        debug(1) << "Injecting non-temporal store fences...\n";
+        s = inject_non_temporal_fences(s, env);
+        debug(2) << "Lowering after injecting non-temporal store fences:\n" << s << "\n\n";
+
         if (t.has_feature(Target::Profile)) {
             debug(1) << "Injecting profiling...\n";
             s = inject_profiling(s, pipeline_name);
@@ -376,6 +408,20 @@ Module lower(const vector<Function> &output_funcs, const string &pipeline_name,
         s = simplify(s);
         debug(1) << "Lowering after final simplification:\n" << s << "\n\n";
 
+        if (t.has_feature(Target::Profile)) {
+            // Counting branches perturbs the timings the profiler
+            // reports, so only do it if asked for a branch profile.
+            if (!get_env_variable("HL_BRANCH_PROFILE").empty()) {
+                debug(1) << "Injecting branch counters...\n";
+                s = inject_branch_counters(s, pipeline_name);
+                debug(2) << "Lowering after injecting branch counters:\n" << s << "\n\n";
+            }
+        } else {
+            debug(1) << "Applying branch profile...\n";
+            s = apply_branch_profile(s, pipeline_name);
+            debug(2) << "Lowering after applying branch profile:\n" << s << "\n\n";
+        }
+
         debug(1) << "Splitting off Hexagon offload...\n";
         s = inject_hexagon_rpc(s, t, result_module);
         debug(2) << "Lowering after splitting off Hexagon offload:\n" << s << '\n';
@@ -15,8 +15,12 @@ namespace Internal {
 namespace {
 
 class FindParameterDependencies : public IRGraphVisitor {
+    // If true, buffer parameters are assumed to be immutable and do
+    // not contribute to the key (see Func::store_persistent).
+    bool ignore_buffers;
+
 public:
-    FindParameterDependencies() { }
+    FindParameterDependencies(bool ignore_buffers) : ignore_buffers(ignore_buffers) { }
     ~FindParameterDependencies() { }
 
     void visit_function(const Function &function) {
@@ -84,7 +88,9 @@ public:
 
         info.type = parameter.type();
 
-        if (parameter.is_buffer()) {
+        if (parameter.is_buffer() && ignore_buffers) {
+            return;
+        } else if (parameter.is_buffer()) {
             internal_error << "Buffer parameter " << parameter.name() <<
                 " encountered in computed_cached computation.\n" <<
                 "Computations which depend on buffer parameters " <<
@@ -143,6 +149,55 @@ public:
 
 typedef std::pair<FindParameterDependencies::DependencyKey, FindParameterDependencies::DependencyInfo> DependencyKeyInfoPair;
 
+// The names of the buffers for each tuple element of a Func.
+std::string tuple_buffer_name(int32_t tuple_count, int32_t i,
+                              const std::string &base_name, const std::string &suffix) {
+    if (tuple_count == 1) {
+        return base_name + suffix;
+    } else {
+        return base_name + "." + std::to_string(i) + suffix;
+    }
+}
+
+// An array of pointers to the buffers for each tuple element.
+Expr tuple_buffers(int32_t tuple_count, const std::string &base_name, const std::string &suffix) {
+    std::vector<Expr> buffers;
+    for (int32_t i = 0; i < tuple_count; i++) {
+        buffers.push_back(Variable::make(type_of<halide_buffer_t *>(),
+                                         tuple_buffer_name(tuple_count, i, base_name, suffix)));
+    }
+    return Call::make(type_of<halide_buffer_t **>(), Call::make_struct, buffers, Call::Intrinsic);
+}
+
+// A buffer describing the region of f computed by one produce node.
+Expr computed_bounds(const Function &f, const std::string &name) {
+    BufferBuilder builder;
+    builder.dimensions = f.dimensions();
+    std::string max_stage_num = std::to_string(f.updates().size());
+    for (const std::string &arg : f.args()) {
+        std::string prefix = name + ".s" + max_stage_num + "." + arg;
+        Expr min = Variable::make(Int(32), prefix + ".min");
+        Expr max = Variable::make(Int(32), prefix + ".max");
+        builder.mins.push_back(min);
+        builder.extents.push_back(max + 1 - min);
+    }
+    return builder.build();
+}
+
+// Outputs are stored in buffers supplied by the caller, and Funcs
+// stored outside their compute level share one allocation between
+// many produce nodes. In both cases the allocation can't be the
+// cache's, so instead each produce node copies its result to and
+// from the cache.
+bool memoized_by_copy(const Function &f, const std::vector<Function> &outputs) {
+    for (const Function &o : outputs) {
+        if (f.same_as(o)) {
+            return true;
+        }
+    }
+    return !f.schedule().compute_level().match(f.schedule().store_level());
+}
+
 class KeyInfo {
     FindParameterDependencies dependencies;
     Expr key_size_expr;
@@ -166,27 +221,36 @@ class KeyInfo {
         return size_t(1) << i;
     }
 
-// TODO: Using the full names in the key results in a (hopefully incredibly
-// slight) performance difference based on how one names filters and
-// functions. It is arguably a little easier to debug if something
-// goes wrong as one doesn't need to destructure the cache key by hand
-// in the debugger. Also, if a pointer is used, a counter must also be
-// put in the cache key to avoid aliasing on reuse of the address in
-// JIT situations where code is regenerated into the same region of
-// memory.
-//
-// There is a plan to change the hash function used in the cache and
-// after that happens, we'll measure performance again and maybe decide
-// to choose one path or the other (see Git history for the implementation.
-// It was deleted as part of the address_of intrinsic cleanup).
+    // The key starts with a 128-bit identity for the function,
+    // computed at compile time from the pipeline and function names
+    // and a counter. A counter is needed because names can be reused
+    // by JIT code compiled in the same process. Keeping this part of
+    // the key short and fixed-size makes hashing and comparing keys
+    // cheap in the runtime, which matters when memoizing per tile.
+    static const size_t identity_bytes = 16;
+
+    // A 64-bit FNV-1a hash of a string with the given multiplier,
+    // followed by the splitmix64 finalizer to spread the bits.
+    static uint64_t hash_string(const std::string &s, uint64_t seed, uint64_t multiplier) {
+        uint64_t h = seed;
+        for (char c : s) {
+            h = (h ^ (uint8_t)c) * multiplier;
+        }
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
 
 public:
   KeyInfo(const Function &function, const std::string &name)
-        : top_level_name(name), function_name(function.name())
+        : dependencies(function.schedule().persistent()),
+          top_level_name(name), function_name(function.name())
     {
         dependencies.visit_function(function);
-        size_t size_so_far = 0;
-        size_so_far += Handle().bytes() + 4;
+        size_t size_so_far = identity_bytes;
 
         size_t needed_alignment = parameters_alignment();
         if (needed_alignment > 1) {
@@ -210,28 +274,20 @@ public:
         std::vector<Stmt> writes;
         Expr index = Expr(0);
 
-        // Store a pointer to a string identifying the filter and
-        // function. Assume this will be unique due to CSE. This can
-        // break with loading and unloading of code, though the name
-        // mechanism can also break in those conditions. For JIT, a
-        // counter is needed as the address may be reused. This isn't
-        // a problem when using full names as the function names
-        // already are uniquefied by a counter.
-        writes.push_back(Store::make(key_name,
-                                     StringImm::make(std::to_string(top_level_name.size()) + ":" + top_level_name +
-                                                     std::to_string(function_name.size()) + ":" + function_name),
-                                     (index / Handle().bytes()), Parameter(), const_true()));
-        size_t alignment = Handle().bytes();
-        index += Handle().bytes();
-
         // Halide compilation is not threadsafe anyway...
         static std::atomic<int> memoize_instance {0};
-        writes.push_back(Store::make(key_name,
-                                     memoize_instance++,
-                                     (index / Int(32).bytes()),
-                                     Parameter(), const_true()));
-        alignment += 4;
-        index += 4;
+        std::string identity = (std::to_string(top_level_name.size()) + ":" + top_level_name +
+                                std::to_string(function_name.size()) + ":" + function_name +
+                                ":" + std::to_string(memoize_instance++));
+        // Two hashes with different multipliers give the two halves.
+        uint64_t identity_lo = hash_string(identity, 0xcbf29ce484222325ULL, 0x100000001b3ULL);
+        uint64_t identity_hi = hash_string(identity, 0x9e3779b97f4a7c15ULL, 0xff51afd7ed558ccdULL);
+        writes.push_back(Store::make(key_name, make_const(UInt(64), identity_lo),
+                                     0, Parameter(), const_true()));
+        writes.push_back(Store::make(key_name, make_const(UInt(64), identity_hi),
+                                     1, Parameter(), const_true()));
+        size_t alignment = identity_bytes;
+        index += (int32_t)identity_bytes;
 
         size_t needed_alignment = parameters_alignment();
         if (needed_alignment > 1) {
@@ -260,42 +316,28 @@ public:
     // or false, in which case it will be assumed the buffer was populated
     // by the code in this call.
     Expr generate_lookup(std::string key_allocation_name, std::string computed_bounds_name,
-                         int32_t tuple_count, std::string storage_base_name) {
+                         int32_t tuple_count, std::string storage_base_name,
+                         std::string buffer_suffix = ".buffer") {
         std::vector<Expr> args;
         args.push_back(Variable::make(type_of<uint8_t *>(), key_allocation_name));
         args.push_back(key_size());
         args.push_back(Variable::make(type_of<halide_buffer_t *>(), computed_bounds_name));
         args.push_back(tuple_count);
-        std::vector<Expr> buffers;
-        if (tuple_count == 1) {
-            buffers.push_back(Variable::make(type_of<halide_buffer_t *>(), storage_base_name + ".buffer"));
-        } else {
-            for (int32_t i = 0; i < tuple_count; i++) {
-                buffers.push_back(Variable::make(type_of<halide_buffer_t *>(), storage_base_name + "." + std::to_string(i) + ".buffer"));
-            }
-        }
-        args.push_back(Call::make(type_of<halide_buffer_t **>(), Call::make_struct, buffers, Call::Intrinsic));
+        args.push_back(tuple_buffers(tuple_count, storage_base_name, buffer_suffix));
 
         return Call::make(Int(32), "halide_memoization_cache_lookup", args, Call::Extern);
     }
 
     // Returns a statement which will store the result of a computation under this key
     Stmt store_computation(std::string key_allocation_name, std::string computed_bounds_name,
-                           int32_t tuple_count, std::string storage_base_name) {
+                           int32_t tuple_count, std::string storage_base_name,
+                           std::string buffer_suffix = ".buffer") {
         std::vector<Expr> args;
         args.push_back(Variable::make(type_of<uint8_t *>(), key_allocation_name));
         args.push_back(key_size());
         args.push_back(Variable::make(type_of<halide_buffer_t *>(), computed_bounds_name));
         args.push_back(tuple_count);
-        std::vector<Expr> buffers;
-        if (tuple_count == 1) {
-            buffers.push_back(Variable::make(type_of<halide_buffer_t *>(), storage_base_name + ".buffer"));
-        } else {
-            for (int32_t i = 0; i < tuple_count; i++) {
-                buffers.push_back(Variable::make(type_of<halide_buffer_t *>(), storage_base_name + "." + std::to_string(i) + ".buffer"));
-            }
-        }
-        args.push_back(Call::make(type_of<halide_buffer_t **>(), Call::make_struct, buffers, Call::Intrinsic));
+        args.push_back(tuple_buffers(tuple_count, storage_base_name, buffer_suffix));
 
         // This is actually a void call. How to indicate that? Look at Extern_ stuff.
         return Evaluate::make(Call::make(Int(32), "halide_memoization_cache_store", args, Call::Extern));
@@ -321,28 +363,11 @@ private:
     void visit(const Realize *op) {
         std::map<std::string, Function>::const_iterator iter = env.find(op->name);
         if (iter != env.end() &&
-            iter->second.schedule().memoized()) {
+            iter->second.schedule().memoized() &&
+            !memoized_by_copy(iter->second, outputs)) {
 
             const Function f(iter->second);
 
-            for (const Function &o : outputs) {
-                if (f.same_as(o)) {
-                    user_error << "Function " << f.name() << " cannot be memoized because "
-                               << "it an output of pipeline " << top_level_name << ".\n";
-                }
-            }
-
-            // There are currently problems with the cache key
-            // construction getting moved above the scope of use if
-            // the the compute and store levels are different. It also
-            // has implications for the cache compute/allocated bounds
-            // logic. And it isn't clear it is useful for
-            // anything. Hence this is currently an error.
-            if (!f.schedule().compute_level().match(f.schedule().store_level())) {
-                user_error << "Function " << f.name() << " cannot be memoized because "
-                           << "it has compute and storage scheduled at different loop levels.\n";
-            }
-
             Stmt mutated_body = mutate(op->body);
 
             KeyInfo key_info(f, top_level_name);
@@ -364,19 +389,7 @@ private:
                                               cache_lookup_check);
 
 
-            BufferBuilder builder;
-            builder.dimensions = f.dimensions();
-            std::string max_stage_num = std::to_string(f.updates().size());
-            for (const std::string arg : f.args()) {
-                std::string prefix = op->name + ".s" + max_stage_num + "." + arg;
-                Expr min = Variable::make(Int(32), prefix + ".min");
-                Expr max = Variable::make(Int(32), prefix + ".max");
-                builder.mins.push_back(min);
-                builder.extents.push_back(max + 1 - min);
-            }
-            Expr computed_bounds = builder.build();
-
-            Stmt computed_bounds_let = LetStmt::make(computed_bounds_name, computed_bounds, cache_lookup);
+            Stmt computed_bounds_let = LetStmt::make(computed_bounds_name, computed_bounds(f, op->name), cache_lookup);
 
             Stmt generate_key = Block::make(key_info.generate_key(cache_key_name), computed_bounds_let);
             Stmt cache_key_alloc =
@@ -389,10 +402,94 @@ private:
         }
     }
 
+    // Wrap a produce node of a Func memoized by copy in a lookup. On
+    // a hit, copy the cached region into the Func's storage. On a
+    // miss, compute it, then copy it into the buffers the cache
+    // allocated and store them.
+    Stmt copy_through_cache(const Function &f, const std::string &name, Stmt body) {
+        KeyInfo key_info(f, top_level_name);
+        int32_t tuple_count = f.outputs();
+
+        std::string cache_key_name = name + ".cache_key";
+        std::string cache_result_name = name + ".cache_result";
+        std::string computed_bounds_name = name + ".computed_bounds.buffer";
+        const std::string cached_suffix = ".cached.buffer";
+        Expr computed_bounds_var = Variable::make(type_of<halide_buffer_t *>(), computed_bounds_name);
+        Expr cache_result = Variable::make(Int(32), cache_result_name);
+
+        Expr cached = tuple_buffers(tuple_count, name, cached_suffix);
+        Expr storage = tuple_buffers(tuple_count, name, ".buffer");
+
+        auto copy = [&](Expr src, Expr dst) {
+            std::string result_name = name + ".copy_result";
+            Expr result = Variable::make(Int(32), result_name);
+            Expr call = Call::make(Int(32), "halide_memoization_cache_copy",
+                                   {computed_bounds_var, tuple_count, src, dst},
+                                   Call::Extern);
+            return LetStmt::make(result_name, call, AssertStmt::make(result == 0, result));
+        };
+        Stmt copy_in = copy(cached, storage);
+        Stmt copy_out = copy(storage, cached);
+        Stmt compute = Block::make({body, copy_out,
+                                    key_info.store_computation(cache_key_name, computed_bounds_name,
+                                                               tuple_count, name, cached_suffix)});
+
+        // Hand the cached buffers back whether they were found or
+        // freshly stored.
+        std::vector<Stmt> releases;
+        for (int32_t i = 0; i < tuple_count; i++) {
+            Expr buf = Variable::make(type_of<halide_buffer_t *>(),
+                                      tuple_buffer_name(tuple_count, i, name, cached_suffix));
+            Expr host = Call::make(Handle(), Call::buffer_get_host, {buf}, Call::Extern);
+            releases.push_back(Evaluate::make(Call::make(Int(32), "halide_memoization_cache_release",
+                                                         {host}, Call::Extern)));
+        }
+
+        Stmt s = Block::make(IfThenElse::make(cache_result == 0, copy_in, compute),
+                             Block::make(releases));
+        s = Block::make(AssertStmt::make(cache_result != -1,
+                                         Call::make(Int(32), "halide_error_out_of_memory", { }, Call::Extern)),
+                        s);
+        s = LetStmt::make(cache_result_name,
+                          key_info.generate_lookup(cache_key_name, computed_bounds_name,
+                                                   tuple_count, name, cached_suffix),
+                          s);
+
+        // The cache fills in the host pointers of dense buffers
+        // covering the computed region.
+        for (int32_t i = 0; i < tuple_count; i++) {
+            BufferBuilder builder;
+            builder.type = f.output_types()[i];
+            builder.dimensions = f.dimensions();
+            Expr stride = 1;
+            for (int d = 0; d < f.dimensions(); d++) {
+                Expr min = Call::make(Int(32), Call::buffer_get_min, {computed_bounds_var, d}, Call::Extern);
+                Expr extent = Call::make(Int(32), Call::buffer_get_extent, {computed_bounds_var, d}, Call::Extern);
+                builder.mins.push_back(min);
+                builder.extents.push_back(extent);
+                builder.strides.push_back(stride);
+                stride *= extent;
+            }
+            s = LetStmt::make(tuple_buffer_name(tuple_count, i, name, cached_suffix), builder.build(), s);
+        }
+
+        s = LetStmt::make(computed_bounds_name, computed_bounds(f, name), s);
+        s = Block::make(key_info.generate_key(cache_key_name), s);
+        return Allocate::make(cache_key_name, UInt(8), {key_info.key_size()}, const_true(), s);
+    }
+
     void visit(const ProducerConsumer *op) {
         std::map<std::string, Function>::const_iterator iter = env.find(op->name);
         if (iter != env.end() &&
-            iter->second.schedule().memoized()) {
+            iter->second.schedule().memoized() &&
+            memoized_by_copy(iter->second, outputs)) {
+            Stmt body = mutate(op->body);
+            if (op->is_producer) {
+                body = copy_through_cache(iter->second, op->name, body);
+            }
+            stmt = ProducerConsumer::make(op->name, op->is_producer, body);
+        } else if (iter != env.end() &&
+                   iter->second.schedule().memoized()) {
 
             // The error checking should have been done inside Realization node
             // of this producer, so no need to do it here.
@@ -463,7 +560,10 @@ private:
         std::string realization_name = get_realization_name(allocation->name);
         std::map<std::string, Function>::const_iterator iter = env.find(realization_name);
 
-        if (iter != env.end() && iter->second.schedule().memoized()) {
+        // Outputs have no Allocate node, so there's no need to pass
+        // them to memoized_by_copy.
+        if (iter != env.end() && iter->second.schedule().memoized() &&
+            !memoized_by_copy(iter->second, std::vector<Function>())) {
             std::string old_innermost_realization_name = innermost_realization_name;
             innermost_realization_name = realization_name;
 
@@ -17,7 +17,8 @@ namespace Internal {
 /** Transform pipeline calls for Funcs scheduled with memoize to do a
  *  lookup call to the runtime cache implementation, and if there is a
  *  miss, compute the results and call the runtime to store it back to
- *  the cache.
+ *  the cache. Outputs, and Funcs stored outside their compute level,
+ *  are instead copied to and from the cache around each produce node.
  *  Should leave non-memoized Funcs unchanged.
  */
 Stmt inject_memoization(Stmt s, const std::map<std::string, Function> &env,
@@ -0,0 +1,570 @@
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include "MemoryPlanning.h"
+#include "CodeGen_Internal.h"
+#include "ExprUsesVar.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "Scope.h"
+#include "Simplify.h"
+#include "Substitute.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::pair;
+using std::set;
+using std::string;
+using std::vector;
+
+namespace {
+
+// Offsets within a slab are multiples of this many bytes. It's at
+// least the native vector width of every target, so codegen can
+// continue to assume that internal allocations are aligned.
+const int slab_alignment = 128;
+
+struct Candidate {
+    string name;
+    // The size in bytes, rounded up to a multiple of slab_alignment,
+    // computed at the top of the region.
+    Expr size;
+    // The positions of the Allocate node and the Free marker in
+    // program order.
+    int start = 0, end = -1;
+    int group = -1;
+    bool valid = true;
+};
+
+// Check if an expression can be evaluated earlier than where it
+// appears, provided all the variables it refers to are defined.
+class CanHoist : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Load *op) {
+        result = false;
+    }
+
+    void visit(const Call *op) {
+        // Fields of buffers are fixed once the buffer exists.
+        if (!op->is_pure() && !starts_with(op->name, "_halide_buffer_get_")) {
+            result = false;
+        }
+        IRVisitor::visit(op);
+    }
+
+public:
+    bool result = true;
+};
+
+// Walk the straight-line part of a region (not entering loops or
+// branches), finding heap allocations and the positions of their
+// Allocate nodes and Free markers.
+class FindCandidates : public IRVisitor {
+    using IRVisitor::visit;
+
+    int position = 0;
+
+    // The lets and allocations enclosing the current node, from the
+    // top of the region inwards.
+    vector<pair<string, Expr>> lets;
+    Scope<int> defined;
+
+    void visit(const For *op) {
+        position++;
+    }
+
+    void visit(const IfThenElse *op) {
+        position++;
+    }
+
+    void visit(const LetStmt *op) {
+        lets.push_back({op->name, op->value});
+        defined.push(op->name, 0);
+        op->body.accept(this);
+        defined.pop(op->name);
+        lets.pop_back();
+    }
+
+    Expr size_at_top(const Allocate *op) {
+        Expr bytes = make_const(Int(64), op->type.bytes());
+        for (Expr e : op->extents) {
+            bytes *= cast<int64_t>(e);
+        }
+        // Codegen pads heap allocations by one element.
+        bytes += op->type.bytes();
+        Expr size = ((max(bytes, 0) + slab_alignment - 1) / slab_alignment) * slab_alignment;
+        size = select(op->condition, size, make_zero(Int(64)));
+
+        for (size_t i = lets.size(); i > 0; i--) {
+            size = substitute(lets[i - 1].first, lets[i - 1].second, size);
+        }
+
+        CanHoist check;
+        size.accept(&check);
+        if (!check.result || expr_uses_vars(size, defined)) {
+            return Expr();
+        }
+        return simplify(size);
+    }
+
+    void visit(const Allocate *op) {
+        int32_t constant_size = op->constant_allocation_size();
+        bool on_heap = !op->extents.empty() &&
+            !(constant_size > 0 && can_allocation_fit_on_stack((int64_t)constant_size * op->type.bytes()));
+        bool eligible = (on_heap &&
+                         !op->new_expr.defined() &&
+                         op->free_function.empty() &&
+                         slab_alignment % op->type.bytes() == 0);
+
+        int idx = -1;
+        if (eligible) {
+            Expr size = size_at_top(op);
+            if (size.defined()) {
+                idx = (int)candidates.size();
+                Candidate c;
+                c.name = op->name;
+                c.size = size;
+                c.start = position++;
+                candidates.push_back(c);
+                current.push(op->name, idx);
+            }
+        }
+
+        defined.push(op->name, 0);
+        op->body.accept(this);
+        defined.pop(op->name);
+
+        if (idx >= 0) {
+            current.pop(op->name);
+            if (candidates[idx].end < 0) {
+                candidates[idx].end = position++;
+            }
+        }
+    }
+
+    void visit(const Free *op) {
+        if (current.contains(op->name)) {
+            candidates[current.get(op->name)].end = position++;
+        }
+    }
+
+    // The candidates we're currently inside, by name.
+    Scope<int> current;
+
+public:
+    vector<Candidate> candidates;
+};
+
+// Find uses of allocations that we can't redirect into a slab: uses
+// of the pointer or buffer itself, and accesses from device code.
+class FindEscapes : public IRVisitor {
+    using IRVisitor::visit;
+
+    bool in_device_code = false;
+
+    void escape(const string &name) {
+        auto it = index.find(name);
+        if (it != index.end()) {
+            candidates[it->second].valid = false;
+        }
+    }
+
+    void visit(const Variable *op) {
+        if (ends_with(op->name, ".buffer")) {
+            escape(op->name.substr(0, op->name.size() - 7));
+        } else {
+            escape(op->name);
+        }
+    }
+
+    void visit(const Call *op) {
+        escape(op->name);
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Load *op) {
+        if (in_device_code) {
+            escape(op->name);
+        }
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Store *op) {
+        if (in_device_code) {
+            escape(op->name);
+        }
+        IRVisitor::visit(op);
+    }
+
+    void visit(const For *op) {
+        bool old_in_device_code = in_device_code;
+        if (op->device_api != DeviceAPI::None &&
+            op->device_api != DeviceAPI::Host) {
+            in_device_code = true;
+        }
+        IRVisitor::visit(op);
+        in_device_code = old_in_device_code;
+    }
+
+    map<string, int> index;
+
+public:
+    vector<Candidate> &candidates;
+
+    FindEscapes(vector<Candidate> &c) : candidates(c) {
+        for (size_t i = 0; i < c.size(); i++) {
+            auto it = index.find(c[i].name);
+            if (it != index.end()) {
+                // The same name is allocated twice in this region.
+                c[i].valid = false;
+                c[it->second].valid = false;
+            } else {
+                index[c[i].name] = (int)i;
+            }
+        }
+    }
+};
+
+// Count the allocations of a set of buffers inside a statement.
+class CountAllocations : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Allocate *op) {
+        if (names.count(op->name)) {
+            count++;
+        }
+        IRVisitor::visit(op);
+    }
+
+    const set<string> &names;
+
+public:
+    int count = 0;
+
+    CountAllocations(const set<string> &names) : names(names) {}
+};
+
+// Wrap the innermost statement that contains the allocations of all
+// of a set of buffers in a new allocation, so that it only exists
+// while they might.
+class InjectAllocation : public IRMutator {
+    const set<string> &members;
+    bool injected = false;
+
+public:
+    using IRMutator::mutate;
+
+    string name;
+    vector<Expr> extents;
+    Expr new_expr;
+    string free_function;
+    // Checks and lets to place just outside the allocation.
+    Stmt check;
+    vector<pair<string, Expr>> lets;
+
+    InjectAllocation(const set<string> &members) : members(members) {}
+
+    Stmt mutate(const Stmt &s) override {
+        if (injected || !s.defined()) {
+            return s;
+        }
+        CountAllocations counter(members);
+        s.accept(&counter);
+        if (counter.count < (int)members.size()) {
+            return s;
+        }
+        Stmt result = IRMutator::mutate(s);
+        if (!injected) {
+            result = Allocate::make(name, UInt(8), extents, const_true(), result, new_expr, free_function);
+            if (check.defined()) {
+                result = Block::make(check, result);
+            }
+            for (size_t i = lets.size(); i > 0; i--) {
+                result = LetStmt::make(lets[i - 1].first, lets[i - 1].second, result);
+            }
+            injected = true;
+        }
+        return result;
+    }
+};
+
+// Replace the members of a slab with the buffers for their ranges of
+// it, and move their frees to the slab and those buffers.
+class PlaceInSlab : public IRMutator {
+    using IRMutator::visit;
+
+    void visit(const Load *op) {
+        auto it = group_of.find(op->name);
+        if (it != group_of.end()) {
+            Expr index = mutate(op->index);
+            Expr predicate = mutate(op->predicate);
+            expr = Load::make(op->type, it->second, index, op->image, op->param, predicate);
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+    void visit(const Store *op) {
+        auto it = group_of.find(op->name);
+        if (it != group_of.end()) {
+            Expr value = mutate(op->value);
+            Expr index = mutate(op->index);
+            Expr predicate = mutate(op->predicate);
+            stmt = Store::make(it->second, value, index, op->param, predicate);
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+    void visit(const Allocate *op) {
+        if (group_of.count(op->name)) {
+            stmt = mutate(op->body);
+        } else if (op->name == slab || owned.count(op->name)) {
+            // The slab and the buffers for its ranges.
+            Stmt body = mutate(op->body);
+            if (!freed.count(op->name)) {
+                body = Block::make(body, Free::make(op->name));
+            }
+            stmt = Allocate::make(op->name, op->type, op->extents, op->condition,
+                                  body, op->new_expr, op->free_function);
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+    void visit(const Free *op) {
+        auto it = group_of.find(op->name);
+        if (it == group_of.end()) {
+            stmt = op;
+            return;
+        }
+        // A range of the slab can be freed when the last allocation
+        // in it is, and the slab can be freed when the last
+        // allocation in it is.
+        stmt = Evaluate::make(0);
+        if (last_in_group.count(op->name)) {
+            stmt = Free::make(it->second);
+            freed.insert(it->second);
+        }
+        if (op->name == last_member) {
+            stmt = Block::make(stmt, Free::make(slab));
+            freed.insert(slab);
+        }
+    }
+
+    set<string> freed;
+
+    const string &slab, &last_member;
+    const map<string, string> &group_of;
+    const set<string> &last_in_group, &owned;
+
+public:
+    PlaceInSlab(const string &slab, const string &last_member,
+                const map<string, string> &group_of,
+                const set<string> &last_in_group, const set<string> &owned) :
+        slab(slab), last_member(last_member), group_of(group_of),
+        last_in_group(last_in_group), owned(owned) {}
+};
+
+class PlanMemory : public IRMutator {
+    using IRMutator::visit;
+
+    const Target &target;
+
+    void visit(const For *op) {
+        if (op->device_api != DeviceAPI::None &&
+            op->device_api != DeviceAPI::Host) {
+            stmt = op;
+            return;
+        }
+        Stmt body = plan_region(mutate(op->body));
+        if (body.same_as(op->body)) {
+            stmt = op;
+        } else {
+            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body);
+        }
+    }
+
+    void visit(const IfThenElse *op) {
+        Stmt then_case = plan_region(mutate(op->then_case));
+        Stmt else_case = op->else_case;
+        if (else_case.defined()) {
+            else_case = plan_region(mutate(else_case));
+        }
+        if (then_case.same_as(op->then_case) &&
+            else_case.same_as(op->else_case)) {
+            stmt = op;
+        } else {
+            stmt = IfThenElse::make(op->condition, then_case, else_case);
+        }
+    }
+
+public:
+    PlanMemory(const Target &t) : target(t) {}
+
+    Stmt plan_region(Stmt s) {
+        FindCandidates finder;
+        s.accept(&finder);
+        vector<Candidate> &candidates = finder.candidates;
+
+        FindEscapes escapes(candidates);
+        s.accept(&escapes);
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                        [](const Candidate &c) {return !c.valid;}),
+                         candidates.end());
+
+        // Greedily pack the allocations, in the order they're made,
+        // into groups whose members are never live at the same
+        // time. Each group gets its own range of the slab.
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Candidate &a, const Candidate &b) {return a.start < b.start;});
+        vector<vector<int>> groups;
+        vector<int> group_end;
+        for (size_t i = 0; i < candidates.size(); i++) {
+            Candidate &c = candidates[i];
+            for (size_t g = 0; g < groups.size(); g++) {
+                if (group_end[g] < c.start) {
+                    c.group = (int)g;
+                    break;
+                }
+            }
+            if (c.group < 0) {
+                c.group = (int)groups.size();
+                groups.emplace_back();
+                group_end.push_back(-1);
+            }
+            groups[c.group].push_back((int)i);
+            group_end[c.group] = c.end;
+        }
+
+        if (groups.size() == candidates.size()) {
+            // No two allocations can share memory.
+            return s;
+        }
+
+        // The slab must be no larger than the peak memory use with
+        // early frees alone. Look for a point at which each group has
+        // a live member that is at least as large as the rest of the
+        // group. The memory live there is then a lower bound on the
+        // peak, and is the size of the slab.
+        vector<Expr> group_size;
+        for (const Candidate &at : candidates) {
+            vector<int> live(groups.size(), -1);
+            for (size_t i = 0; i < candidates.size(); i++) {
+                const Candidate &c = candidates[i];
+                if (c.start <= at.start && at.start < c.end) {
+                    live[c.group] = (int)i;
+                }
+            }
+            bool dominated = true;
+            for (size_t g = 0; dominated && g < groups.size(); g++) {
+                if (live[g] < 0) {
+                    dominated = false;
+                    break;
+                }
+                for (int i : groups[g]) {
+                    if (i != live[g] &&
+                        !can_prove(candidates[live[g]].size >= candidates[i].size)) {
+                        dominated = false;
+                        break;
+                    }
+                }
+            }
+            if (dominated) {
+                for (size_t g = 0; g < groups.size(); g++) {
+                    group_size.push_back(candidates[live[g]].size);
+                }
+                break;
+            }
+        }
+
+        if (group_size.empty()) {
+            debug(3) << "Not packing " << candidates.size()
+                     << " allocations, because the slab might be larger than their peak memory use\n";
+            return s;
+        }
+
+        string slab = "memory_plan." + unique_name('s');
+
+        // Lay out the ranges, using 64-bit byte offsets so that they
+        // can't overflow.
+        vector<pair<string, Expr>> lets;
+        map<string, string> group_of;
+        set<string> last_in_group, owned, all_members;
+        vector<set<string>> group_members(groups.size());
+        vector<Expr> group_offsets;
+        Expr offset = make_zero(Int(64));
+        for (size_t g = 0; g < groups.size(); g++) {
+            string group_name = slab + "." + std::to_string(g);
+            string offset_name = group_name + ".offset";
+            string size_name = group_name + ".size";
+            for (int i : groups[g]) {
+                const Candidate &c = candidates[i];
+                group_of[c.name] = group_name;
+                group_members[g].insert(c.name);
+                all_members.insert(c.name);
+                debug(3) << "Placing " << c.name << " in " << group_name << "\n";
+            }
+            last_in_group.insert(candidates[groups[g].back()].name);
+            owned.insert(group_name);
+            lets.push_back({offset_name, offset});
+            lets.push_back({size_name, group_size[g]});
+            group_offsets.push_back(Variable::make(Int(64), offset_name));
+            offset = Variable::make(Int(64), offset_name) + Variable::make(Int(64), size_name);
+        }
+        string total_name = slab + ".size";
+        lets.push_back({total_name, offset});
+        Expr total = Variable::make(Int(64), total_name);
+
+        const Candidate *last = &candidates[0];
+        for (const Candidate &c : candidates) {
+            if (c.end > last->end) {
+                last = &c;
+            }
+        }
+
+        debug(2) << "Packing " << candidates.size() << " allocations into "
+                 << groups.size() << " ranges of " << slab << "\n";
+
+        // Allocate the slab lazily, just outside the innermost
+        // statement that contains all of its members, and likewise
+        // for each range of it. The ranges are separate buffers that
+        // point into the slab, so alias analysis can still tell
+        // accesses to different ranges apart.
+        InjectAllocation slab_injector(all_members);
+        slab_injector.name = slab;
+        slab_injector.extents = {cast<int32_t>(total / slab_alignment), slab_alignment};
+        Expr max_size = make_const(UInt(64), target.maximum_buffer_size());
+        Expr error = Call::make(Int(32), "halide_error_buffer_allocation_too_large",
+                                {slab, cast<uint64_t>(total), max_size}, Call::Extern);
+        slab_injector.check = AssertStmt::make(cast<uint64_t>(total) <= max_size, error);
+        slab_injector.lets = lets;
+        s = slab_injector.mutate(s);
+
+        for (size_t g = 0; g < groups.size(); g++) {
+            InjectAllocation group_injector(group_members[g]);
+            group_injector.name = slab + "." + std::to_string(g);
+            Expr base = Load::make(UInt(8), slab, group_offsets[g], Buffer<>(), Parameter(), const_true());
+            group_injector.new_expr = Call::make(Handle(), Call::address_of, {base}, Call::Intrinsic);
+            group_injector.free_function = "halide_device_host_nop_free";
+            s = group_injector.mutate(s);
+        }
+
+        PlaceInSlab place(slab, last->name, group_of, last_in_group, owned);
+        return place.mutate(s);
+    }
+};
+
+}  // namespace
+
+Stmt plan_memory(Stmt s, const Target &t) {
+    PlanMemory planner(t);
+    return planner.plan_region(planner.mutate(s));
+}
+
+}
+}
@@ -0,0 +1,37 @@
+#ifndef HALIDE_MEMORY_PLANNING_H
+#define HALIDE_MEMORY_PLANNING_H
+
+/** \file
+ * Defines the lowering pass that packs heap allocations with disjoint
+ * lifetimes into shared slabs.
+ */
+
+#include "IR.h"
+#include "Target.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Find heap allocations at the same loop level whose lifetimes (from
+ * their Allocate node to their Free marker) don't overlap, and place
+ * them at offsets within a single slab, so that they share one
+ * allocation instead of each making their own. Allocations that are
+ * never live at the same time share a range of the slab, and are
+ * renamed to a single buffer per range, so that accesses to different
+ * ranges can still be told apart by alias analysis. This reduces the
+ * number of calls to halide_malloc, not the number of bytes
+ * allocated, so it is only done when the slab is provably no larger
+ * than the peak memory the allocations would use with early frees
+ * alone. The slab is allocated just outside the innermost statement
+ * that contains all of its members. Allocations that escape into
+ * halide_buffer_t objects (extern stages, device code) are left
+ * alone. Must be called after storage flattening and
+ * inject_early_frees. The slabs show up in the profiler's memory
+ * report as "memory_plan". Only used when the target has
+ * Target::MemoryPlanning. */
+Stmt plan_memory(Stmt s, const Target &t);
+
+}
+}
+
+#endif
@@ -1,8 +1,11 @@
 #include "Module.h"
 
+#include <algorithm>
 #include <array>
 #include <fstream>
 #include <future>
+#include <map>
+#include <set>
 
 #include "CodeGen_C.h"
 #include "CodeGen_Internal.h"
@@ -12,7 +15,9 @@
 #include "LLVM_Output.h"
 #include "LLVM_Runtime_Linker.h"
 #include "IROperator.h"
+#include "IRVisitor.h"
 #include "Outputs.h"
+#include "PythonExtensionGen.h"
 #include "StmtToHtml.h"
 #include "WrapExternStages.h"
 #include "ThreadPool.h"
@@ -93,6 +98,118 @@ Outputs add_suffixes(const Outputs &in, const std::string &suffix) {
     return out;
 }
 
+// A static library can hold any number of objects, so a module can
+// be compiled to one object per externally-visible function plus one
+// for the runtime, and those objects can be generated in
+// parallel. Each function is still a single unit of work (including
+// the closures of its parallel loops, and the internal functions it
+// calls), so this only helps when there is more than one object to
+// make, e.g. a Generator's function built with the runtime, or with
+// batch_entry_point=true. This is only safe if the functions don't
+// depend on anything else in the module that would need to be
+// duplicated or shared across the objects.
+bool can_split_static_library(const Module &m) {
+    size_t num_objects = m.target().has_feature(Target::NoRuntime) ? 0 : 1;
+    for (const auto &f : m.functions()) {
+        if (f.linkage != LoweredFunc::Internal) {
+            num_objects++;
+        }
+    }
+    return num_objects >= 2 && m.buffers().empty() && m.external_code().empty();
+}
+
+class FindExternCalls : public IRGraphVisitor {
+    using IRGraphVisitor::visit;
+
+    void visit(const Call *op) {
+        IRGraphVisitor::visit(op);
+        if (op->call_type == Call::Extern || op->call_type == Call::ExternCPlusPlus) {
+            names.insert(op->name);
+        }
+    }
+
+public:
+    std::set<std::string> names;
+};
+
+// Get the internal functions that f calls, directly or through other
+// internal functions, callees first. They go in the same object as f.
+std::vector<LoweredFunc> internal_callees(const Module &m, const LoweredFunc &f) {
+    std::map<std::string, const LoweredFunc *> internal;
+    for (const auto &g : m.functions()) {
+        if (g.linkage == LoweredFunc::Internal) {
+            internal[g.name] = &g;
+        }
+    }
+
+    std::vector<LoweredFunc> result;
+    std::set<std::string> seen;
+    std::vector<const LoweredFunc *> pending = {&f};
+    while (!pending.empty()) {
+        FindExternCalls calls;
+        pending.back()->body.accept(&calls);
+        pending.pop_back();
+        for (const auto &name : calls.names) {
+            auto it = internal.find(name);
+            if (it != internal.end() && seen.insert(name).second) {
+                result.push_back(*it->second);
+                pending.push_back(it->second);
+            }
+        }
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+void compile_split_static_library(const Module &module, const std::string &static_library_name) {
+    // If we are running with HL_DEBUG_CODEGEN=1, use threads=1 to enforce
+    // sequential execution, so that debug output won't be utterly incomprehensible
+    const size_t num_threads = (debug::debug_level() > 0) ? 1 : Internal::ThreadPool<void>::num_processors_online();
+    Internal::ThreadPool<void> pool(num_threads);
+    std::vector<std::future<void>> futures;
+
+    TemporaryObjectFileDir temp_dir;
+
+    // Each externally-visible function gets its own LLVM module,
+    // compiled without the runtime, which goes in an object of its
+    // own.
+    Target function_target = module.target().with_feature(Target::NoRuntime);
+    for (const auto &f : module.functions()) {
+        if (f.linkage == LoweredFunc::Internal) {
+            continue;
+        }
+        Module function_module(module.name() + "_" + f.name, function_target);
+        for (const auto &callee : internal_callees(module, f)) {
+            function_module.append(callee);
+        }
+        function_module.append(f);
+        Outputs function_out = Outputs().object(
+            temp_dir.add_temp_object_file(static_library_name, "_" + f.name, module.target()));
+        futures.emplace_back(pool.async([](Module m, Outputs o) {
+            debug(1) << "Module.compile(): split function " << o.object_name << "\n";
+            m.compile(o);
+        }, std::move(function_module), std::move(function_out)));
+    }
+
+    if (!module.target().has_feature(Target::NoRuntime)) {
+        Outputs runtime_out = Outputs().object(
+            temp_dir.add_temp_object_file(static_library_name, "_runtime", module.target()));
+        futures.emplace_back(pool.async([](Target t, Outputs o) {
+            debug(1) << "Module.compile(): split runtime " << o.object_name << "\n";
+            compile_standalone_runtime(o, t);
+        }, module.target(), std::move(runtime_out)));
+    }
+
+    // Must wait for everything to finish before we create the static library
+    for (auto &f : futures) {
+        f.wait();
+    }
+
+    debug(1) << "Module.compile(): static_library_name " << static_library_name << "\n";
+    Target base_target(module.target().os, module.target().arch, module.target().bits);
+    create_static_library(temp_dir.files(), base_target, static_library_name);
+}
+
 uint64_t target_feature_mask(const Target &target) {
     static_assert(sizeof(uint64_t)*8 >= Target::FeatureEnd, "Features will not fit in uint64_t");
     uint64_t feature_mask = 0;
@@ -312,9 +429,15 @@ void Module::compile(const Outputs &output_files) const {
         return;
     }
 
+    const bool split_static_library =
+        !output_files.static_library_name.empty() && can_split_static_library(*this);
+    if (split_static_library) {
+        compile_split_static_library(*this, output_files.static_library_name);
+    }
+
     if (!output_files.object_name.empty() || !output_files.assembly_name.empty() ||
         !output_files.bitcode_name.empty() || !output_files.llvm_assembly_name.empty() ||
-        !output_files.static_library_name.empty()) {
+        (!output_files.static_library_name.empty() && !split_static_library)) {
         llvm::LLVMContext context;
         std::unique_ptr<llvm::Module> llvm_module(compile_module_to_llvm_module(*this, context));
 
@@ -323,7 +446,7 @@ void Module::compile(const Outputs &output_files) const {
             auto out = make_raw_fd_ostream(output_files.object_name);
             compile_llvm_module_to_object(*llvm_module, *out);
         }
-        if (!output_files.static_library_name.empty()) {
+        if (!output_files.static_library_name.empty() && !split_static_library) {
             // To simplify the code, we always create a temporary object output
             // here, even if output_files.object_name was also set: in practice,
             // no real-world code ever sets both object_name and static_library_name
@@ -376,6 +499,12 @@ void Module::compile(const Outputs &output_files) const {
                                Internal::CodeGen_C::CPlusPlusImplementation : Internal::CodeGen_C::CImplementation);
         cg.compile(*this);
     }
+    if (!output_files.python_extension_name.empty()) {
+        debug(1) << "Module.compile(): python_extension_name " << output_files.python_extension_name << "\n";
+        std::ofstream file(output_files.python_extension_name);
+        Internal::PythonExtensionGen python_extension_gen(file);
+        python_extension_gen.compile(*this);
+    }
     if (!output_files.stmt_name.empty()) {
         debug(1) << "Module.compile(): stmt_name " << output_files.stmt_name << "\n";
         std::ofstream file(output_files.stmt_name);
@@ -448,8 +577,9 @@ void compile_multitarget(const std::string &fn_name,
     uint64_t runtime_features_mask = (uint64_t)-1LL;
 
     TemporaryObjectFileDir temp_dir;
-    std::vector<Expr> wrapper_args;
-    std::vector<LoweredArgument> base_target_args;
+    std::vector<Expr> wrapper_args, batch_wrapper_args;
+    std::vector<LoweredArgument> base_target_args, base_target_batch_args;
+    bool has_batch_wrapper = false;
     for (const Target &target : targets) {
         // arch-bits-os must be identical across all targets.
         if (target.os != base_target.os ||
@@ -494,6 +624,15 @@ void compile_multitarget(const std::string &fn_name,
         // Re-assign every time -- should be the same across all targets anyway,
         // but base_target is always the last one we encounter.
         base_target_args = sub_module.get_function_by_name(sub_fn_name).args;
+        // If the sub-modules have batched entry points, the wrapper
+        // gets one too. It dispatches the whole batch to one of them.
+        has_batch_wrapper = false;
+        for (const auto &f : sub_module.functions()) {
+            if (f.name == sub_fn_name + "_batch") {
+                has_batch_wrapper = true;
+                base_target_batch_args = f.args;
+            }
+        }
 
         Outputs sub_out = add_suffixes(output_files, suffix);
         internal_assert(sub_out.object_name.empty());
@@ -514,6 +653,8 @@ void compile_multitarget(const std::string &fn_name,
 
         wrapper_args.push_back(can_use != 0);
         wrapper_args.push_back(sub_fn_name);
+        batch_wrapper_args.push_back(can_use != 0);
+        batch_wrapper_args.push_back(sub_fn_name + "_batch");
     }
 
     // If we haven't specified "no runtime", build a runtime with the base target
@@ -570,6 +711,14 @@ void compile_multitarget(const std::string &fn_name,
 
         // Add a wrapper to accept old buffer_ts
         add_legacy_wrapper(wrapper_module, wrapper_module.functions().back());
+        if (has_batch_wrapper) {
+            Expr indirect_batch_result = Call::make(Int(32), Call::call_cached_indirect_function, batch_wrapper_args, Call::Intrinsic);
+            std::string private_batch_result_name = unique_name(fn_name + "_batch_result");
+            Expr private_batch_result_var = Variable::make(Int(32), private_batch_result_name);
+            Stmt batch_wrapper_body = AssertStmt::make(private_batch_result_var == 0, private_batch_result_var);
+            batch_wrapper_body = LetStmt::make(private_batch_result_name, indirect_batch_result, batch_wrapper_body);
+            wrapper_module.append(LoweredFunc(fn_name + "_batch", base_target_batch_args, batch_wrapper_body, LoweredFunc::External));
+        }
 
         Outputs wrapper_out = Outputs().object(
             temp_dir.add_temp_object_file(output_files.static_library_name, "_wrapper", base_target, /* in_front*/ true));
@@ -579,12 +728,19 @@ void compile_multitarget(const std::string &fn_name,
         }, std::move(wrapper_module), std::move(wrapper_out)));
     }
 
-    if (!output_files.c_header_name.empty()) {
+    if (!output_files.c_header_name.empty() || !output_files.python_extension_name.empty()) {
         Module header_module(fn_name, base_target);
         header_module.append(LoweredFunc(fn_name, base_target_args, {}, LoweredFunc::ExternalPlusMetadata));
         // Add a wrapper to accept old buffer_ts
         add_legacy_wrapper(header_module, header_module.functions().back());
-        Outputs header_out = Outputs().c_header(output_files.c_header_name);
+        if (has_batch_wrapper) {
+            header_module.append(LoweredFunc(fn_name + "_batch", base_target_batch_args, {}, LoweredFunc::External));
+        }
+        // The Python extension only refers to the wrapper's entry
+        // points, so it can be generated from the same declarations.
+        Outputs header_out;
+        header_out.c_header_name = output_files.c_header_name;
+        header_out.python_extension_name = output_files.python_extension_name;
         futures.emplace_back(pool.async([](Module m, Outputs o) {
             debug(1) << "compile_multitarget: c_header_name " << o.c_header_name << "\n";
             m.compile(o);
@@ -0,0 +1,248 @@
+#include <map>
+
+#include "NarrowArithmetic.h"
+#include "Bounds.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "Scope.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::string;
+using std::vector;
+
+namespace {
+
+const Call *as_shift(const Expr &e) {
+    const Call *c = e.as<Call>();
+    if (c && (c->is_intrinsic(Call::shift_left) ||
+              c->is_intrinsic(Call::shift_right))) {
+        return c;
+    }
+    return nullptr;
+}
+
+bool is_arithmetic(const Expr &e) {
+    return (e.as<Add>() || e.as<Sub>() || e.as<Mul>() ||
+            e.as<Div>() || e.as<Mod>() ||
+            e.as<Min>() || e.as<Max>() || e.as<Select>() ||
+            as_shift(e));
+}
+
+bool representable(const Expr &bound, Type t) {
+    if (const int64_t *i = as_const_int(bound)) {
+        return t.can_represent(*i);
+    } else if (const uint64_t *u = as_const_uint(bound)) {
+        return t.can_represent(*u);
+    }
+    return false;
+}
+
+class NarrowArithmetic : public IRMutator {
+    using IRMutator::visit;
+
+    // Bounds of the enclosing lets.
+    Scope<Interval> bounds;
+
+    Interval constant_bounds(Expr e) {
+        Interval result;
+        Expr lo = find_constant_bound(e, Direction::Lower, bounds);
+        Expr hi = find_constant_bound(e, Direction::Upper, bounds);
+        if (lo.defined()) {
+            result.min = lo;
+        }
+        if (hi.defined()) {
+            result.max = hi;
+        }
+        return result;
+    }
+
+    // The bounds of the nodes of the expression we're currently
+    // trying to narrow, which we test against each candidate type.
+    std::map<const IRNode *, Interval> bounds_cache;
+
+    // Check every value e takes is representable in t.
+    bool fits(Expr e, Type t) {
+        auto it = bounds_cache.find(e.get());
+        if (it == bounds_cache.end()) {
+            it = bounds_cache.emplace(e.get(), constant_bounds(e)).first;
+        }
+        const Interval &i = it->second;
+        return (i.is_bounded() &&
+                representable(i.min, t) &&
+                representable(i.max, t));
+    }
+
+    template<typename T>
+    Expr narrow_binary(const T *op, Type t) {
+        Expr a = narrow(op->a, t);
+        Expr b = a.defined() ? narrow(op->b, t) : Expr();
+        if (!b.defined()) {
+            return Expr();
+        }
+        return T::make(a, b);
+    }
+
+    // Compute e in type t, which has the same number of lanes. The
+    // result, cast back to e's type, is equal to e. Returns an
+    // undefined Expr if we can't prove that. The leaves aren't
+    // mutated.
+    Expr narrow(Expr e, Type t) {
+        if (const Cast *c = e.as<Cast>()) {
+            Type from = c->value.type();
+            if (!(from.is_int() || from.is_uint())) {
+                return Expr();
+            }
+            if (t.can_represent(from) || fits(e, t)) {
+                return cast(t, c->value);
+            }
+            return Expr();
+        }
+
+        if (!fits(e, t)) {
+            return Expr();
+        }
+
+        if (is_const(e)) {
+            return cast(t, e);
+        } else if (const Broadcast *b = e.as<Broadcast>()) {
+            // Narrowing a scalar is cheap.
+            return Broadcast::make(cast(t.element_of(), b->value), b->lanes);
+        } else if (e.as<Variable>()) {
+            return cast(t, e);
+        } else if (const Add *op = e.as<Add>()) {
+            return narrow_binary(op, t);
+        } else if (const Sub *op = e.as<Sub>()) {
+            return narrow_binary(op, t);
+        } else if (const Mul *op = e.as<Mul>()) {
+            return narrow_binary(op, t);
+        } else if (const Div *op = e.as<Div>()) {
+            // Division rounds the same way at every width.
+            return narrow_binary(op, t);
+        } else if (const Mod *op = e.as<Mod>()) {
+            return narrow_binary(op, t);
+        } else if (const Min *op = e.as<Min>()) {
+            return narrow_binary(op, t);
+        } else if (const Max *op = e.as<Max>()) {
+            return narrow_binary(op, t);
+        } else if (const Select *op = e.as<Select>()) {
+            Expr true_value = narrow(op->true_value, t);
+            Expr false_value = true_value.defined() ? narrow(op->false_value, t) : Expr();
+            if (!false_value.defined()) {
+                return Expr();
+            }
+            return Select::make(op->condition, true_value, false_value);
+        } else if (const Call *op = as_shift(e)) {
+            // Shifting by a constant amount that's in range for the
+            // narrow type. The result fits, so nothing is shifted out
+            // that wouldn't also be shifted out of the wide type.
+            const int64_t *shift = as_const_int(op->args[1]);
+            const uint64_t *ushift = as_const_uint(op->args[1]);
+            int64_t amount = shift ? *shift : ushift ? (int64_t)*ushift : -1;
+            if (amount < 0 || amount >= t.bits()) {
+                return Expr();
+            }
+            Expr a = narrow(op->args[0], t);
+            if (!a.defined()) {
+                return Expr();
+            }
+            return Call::make(t, op->name, {a, make_const(t, amount)}, Call::PureIntrinsic);
+        }
+        return Expr();
+    }
+
+    void visit(const Load *op) {
+        // Leave indices at 32 bits.
+        Expr predicate = mutate(op->predicate);
+        if (predicate.same_as(op->predicate)) {
+            expr = op;
+        } else {
+            expr = Load::make(op->type, op->name, op->index, op->image, op->param, predicate);
+        }
+    }
+
+    void visit(const Store *op) {
+        Expr value = mutate(op->value);
+        Expr predicate = mutate(op->predicate);
+        if (value.same_as(op->value) && predicate.same_as(op->predicate)) {
+            stmt = op;
+        } else {
+            stmt = Store::make(op->name, value, op->index, op->param, predicate);
+        }
+    }
+
+    void visit(const Let *op) {
+        Expr value = mutate(op->value);
+        bounds.push(op->name, constant_bounds(value));
+        Expr body = mutate(op->body);
+        bounds.pop(op->name);
+        if (value.same_as(op->value) && body.same_as(op->body)) {
+            expr = op;
+        } else {
+            expr = Let::make(op->name, value, body);
+        }
+    }
+
+    void visit(const LetStmt *op) {
+        Expr value = mutate(op->value);
+        bounds.push(op->name, constant_bounds(value));
+        Stmt body = mutate(op->body);
+        bounds.pop(op->name);
+        if (value.same_as(op->value) && body.same_as(op->body)) {
+            stmt = op;
+        } else {
+            stmt = LetStmt::make(op->name, value, body);
+        }
+    }
+
+public:
+    using IRMutator::mutate;
+
+    int count = 0;
+
+    Expr mutate(const Expr &e) override {
+        Type wide = e.type();
+        if (wide.is_vector() &&
+            (wide.is_int() || wide.is_uint()) &&
+            wide.bits() > 8 &&
+            is_arithmetic(e)) {
+            // Try the narrowest types first.
+            vector<Type> candidates;
+            for (int bits : {8, 16}) {
+                if (bits < wide.bits()) {
+                    candidates.push_back(UInt(bits, wide.lanes()));
+                    candidates.push_back(Int(bits, wide.lanes()));
+                }
+            }
+            Expr narrowed;
+            for (Type t : candidates) {
+                narrowed = narrow(e, t);
+                if (narrowed.defined()) {
+                    debug(2) << "Narrowing " << wide << " arithmetic to " << t << ": " << e << "\n";
+                    count++;
+                    break;
+                }
+            }
+            bounds_cache.clear();
+            if (narrowed.defined()) {
+                // Narrow the leaves, and any parts of the narrowed
+                // expression that fit in an even narrower type.
+                return IRMutator::mutate(cast(wide, narrowed));
+            }
+        }
+        return IRMutator::mutate(e);
+    }
+};
+
+}  // namespace
+
+Stmt narrow_arithmetic(Stmt s) {
+    NarrowArithmetic narrower;
+    s = narrower.mutate(s);
+    debug(1) << "Narrowed " << narrower.count << " vector expressions\n";
+    return s;
+}
+
+}
+}
@@ -0,0 +1,26 @@
+#ifndef HALIDE_NARROW_ARITHMETIC_H
+#define HALIDE_NARROW_ARITHMETIC_H
+
+/** \file
+ * Defines the lowering pass that narrows vector integer arithmetic to
+ * the smallest type that can't overflow.
+ */
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Find vector integer expressions of 16 bits or more that are built
+ * from values of narrower types (e.g. uint8 loads widened to int32 for
+ * convenience), and rewrite them to do the arithmetic in the narrowest
+ * 8 or 16-bit type in which interval analysis proves no intermediate
+ * value overflows. Each rewrite is reported at debug level 2. Used
+ * when the target has the narrow_arithmetic feature. Must be called
+ * after vectorization. */
+Stmt narrow_arithmetic(Stmt s);
+
+}
+}
+
+#endif
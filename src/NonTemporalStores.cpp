@@ -0,0 +1,82 @@
+#include "NonTemporalStores.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::string;
+using std::vector;
+
+namespace {
+
+class InjectNonTemporalFences : public IRMutator {
+    using IRMutator::visit;
+
+    const map<string, Function> &env;
+
+    // The buffers of the non-temporal producers we're inside.
+    vector<Expr> buffers;
+    bool in_device_code = false;
+
+    Stmt fence(Stmt body) {
+        Expr call = Call::make(Int(32), Call::non_temporal_fence, buffers, Call::Intrinsic);
+        return Block::make(body, Evaluate::make(call));
+    }
+
+    void visit(const ProducerConsumer *op) {
+        auto it = env.find(op->name);
+        if (!op->is_producer ||
+            in_device_code ||
+            it == env.end() ||
+            !it->second.schedule().non_temporal_stores()) {
+            IRMutator::visit(op);
+            return;
+        }
+
+        const Function &f = it->second;
+        size_t old_size = buffers.size();
+        if (f.outputs() == 1) {
+            buffers.push_back(f.name());
+        } else {
+            for (int i = 0; i < f.outputs(); i++) {
+                buffers.push_back(f.name() + "." + std::to_string(i));
+            }
+        }
+        Stmt body = fence(mutate(op->body));
+        buffers.resize(old_size);
+
+        stmt = ProducerConsumer::make(op->name, op->is_producer, body);
+    }
+
+    void visit(const For *op) {
+        bool old_in_device_code = in_device_code;
+        if (op->device_api != DeviceAPI::None &&
+            op->device_api != DeviceAPI::Host) {
+            in_device_code = true;
+        }
+        IRMutator::visit(op);
+        in_device_code = old_in_device_code;
+
+        // Each task of a parallel loop may run on a different thread,
+        // so it needs its own fence.
+        if (op->for_type == ForType::Parallel && !buffers.empty() && !in_device_code) {
+            op = stmt.as<For>();
+            internal_assert(op);
+            stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api, fence(op->body));
+        }
+    }
+
+public:
+    InjectNonTemporalFences(const map<string, Function> &env) : env(env) {}
+};
+
+}  // namespace
+
+Stmt inject_non_temporal_fences(Stmt s, const map<string, Function> &env) {
+    return InjectNonTemporalFences(env).mutate(s);
+}
+
+}
+}
@@ -0,0 +1,28 @@
+#ifndef HALIDE_NON_TEMPORAL_STORES_H
+#define HALIDE_NON_TEMPORAL_STORES_H
+
+/** \file
+ * Defines the lowering pass that marks the buffers of Funcs scheduled
+ * with store_non_temporal.
+ */
+
+#include <map>
+
+#include "IR.h"
+
+namespace Halide {
+namespace Internal {
+
+/** For each Func scheduled with Func::store_non_temporal, inject a
+ * call to the non_temporal_fence intrinsic, naming its buffers, at the
+ * end of its producer and at the end of the body of each parallel loop
+ * within it. Code generators that support non-temporal stores emit
+ * them for dense vector stores to any buffer named by one of these
+ * calls, and a fence where the call is. Other code generators ignore
+ * the calls. Producers inside device loops are left alone. */
+Stmt inject_non_temporal_fences(Stmt s, const std::map<std::string, Function> &env);
+
+}
+}
+
+#endif
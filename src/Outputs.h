@@ -50,6 +50,11 @@ struct Outputs {
      * output is desired. */
     std::string static_library_name;
 
+    /** The name of the emitted source for a Python extension module
+     * wrapping the functions with metadata. Empty if no Python
+     * extension is desired. */
+    std::string python_extension_name;
+
     /** Make a new Outputs struct that emits everything this one does
      * and also an object file with the given name. */
     Outputs object(const std::string &object_name) const {
@@ -121,6 +126,15 @@ struct Outputs {
         updated.static_library_name = static_library_name;
         return updated;
     }
+
+    /** Make a new Outputs struct that emits everything this one does
+     * and also the source of a Python extension module with the given
+     * name. */
+    Outputs python_extension(const std::string &python_extension_name) const {
+        Outputs updated = *this;
+        updated.python_extension_name = python_extension_name;
+        return updated;
+    }
 };
 
 }
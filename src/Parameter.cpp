@@ -21,6 +21,8 @@ struct ParameterContents {
     std::vector<Expr> stride_constraint;
     std::vector<Expr> min_constraint_estimate;
     std::vector<Expr> extent_constraint_estimate;
+    std::vector<Expr> extent_specialization;
+    std::vector<Expr> stride_specialization;
     Expr min_value, max_value;
     Expr estimate;
 
@@ -38,6 +40,8 @@ struct ParameterContents {
         stride_constraint.resize(dimensions);
         min_constraint_estimate.resize(dimensions);
         extent_constraint_estimate.resize(dimensions);
+        extent_specialization.resize(dimensions);
+        stride_specialization.resize(dimensions);
 
         // stride_constraint[0] defaults to 1. This is important for
         // dense vectorization. You can unset it by setting it to a
@@ -249,6 +253,18 @@ void Parameter::set_extent_constraint_estimate(int dim, Expr extent) {
     contents->extent_constraint_estimate[dim] = extent;
 }
 
+void Parameter::set_extent_specialization(int dim, Expr extent) {
+    check_is_buffer();
+    check_dim_ok(dim);
+    contents->extent_specialization[dim] = extent;
+}
+
+void Parameter::set_stride_specialization(int dim, Expr stride) {
+    check_is_buffer();
+    check_dim_ok(dim);
+    contents->stride_specialization[dim] = stride;
+}
+
 void Parameter::set_host_alignment(int bytes) {
     check_is_buffer();
     contents->host_alignment = bytes;
@@ -284,6 +300,18 @@ Expr Parameter::extent_constraint_estimate(int dim) const {
     return contents->extent_constraint_estimate[dim];
 }
 
+Expr Parameter::extent_specialization(int dim) const {
+    check_is_buffer();
+    check_dim_ok(dim);
+    return contents->extent_specialization[dim];
+}
+
+Expr Parameter::stride_specialization(int dim) const {
+    check_is_buffer();
+    check_dim_ok(dim);
+    return contents->stride_specialization[dim];
+}
+
 int Parameter::host_alignment() const {
     check_is_buffer();
     return contents->host_alignment;
@@ -405,6 +433,16 @@ Dimension Dimension::set_bounds_estimate(Expr min, Expr extent) {
     return set_min_estimate(min).set_extent_estimate(extent);
 }
 
+Dimension Dimension::specialize_extent(Expr extent) {
+    param.set_extent_specialization(d, extent);
+    return *this;
+}
+
+Dimension Dimension::specialize_stride(Expr stride) {
+    param.set_stride_specialization(d, stride);
+    return *this;
+}
+
 Dimension Dimension::dim(int i) {
     return Dimension(param, i);
 }
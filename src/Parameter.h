@@ -122,20 +122,24 @@ public:
     /** Tests if this handle is non-nullptr */
     EXPORT bool defined() const;
 
-    /** Get and set constraints for the min, extent, stride, and estimates on
-     * the min/extent. */
+    /** Get and set constraints for the min, extent, stride, estimates on
+     * the min/extent, and specializations of the extent/stride. */
     //@{
     EXPORT void set_min_constraint(int dim, Expr e);
     EXPORT void set_extent_constraint(int dim, Expr e);
     EXPORT void set_stride_constraint(int dim, Expr e);
     EXPORT void set_min_constraint_estimate(int dim, Expr min);
     EXPORT void set_extent_constraint_estimate(int dim, Expr extent);
+    EXPORT void set_extent_specialization(int dim, Expr extent);
+    EXPORT void set_stride_specialization(int dim, Expr stride);
     EXPORT void set_host_alignment(int bytes);
     EXPORT Expr min_constraint(int dim) const;
     EXPORT Expr extent_constraint(int dim) const;
     EXPORT Expr stride_constraint(int dim) const;
     EXPORT Expr min_constraint_estimate(int dim) const;
     EXPORT Expr extent_constraint_estimate(int dim) const;
+    EXPORT Expr extent_specialization(int dim) const;
+    EXPORT Expr stride_specialization(int dim) const;
     EXPORT int host_alignment() const;
     //@}
 
@@ -227,6 +231,22 @@ public:
      * used by the auto-scheduler. */
     EXPORT Dimension set_bounds_estimate(Expr min, Expr extent);
 
+    /** Declare the extent or stride this dimension is expected to
+     * have. Unlike set_extent and set_stride, buffers that don't
+     * match are still accepted: the whole pipeline is compiled twice,
+     * once with every declared extent and stride substituted as a
+     * constant and once in general, and a single check at the top of
+     * the pipeline picks between them. E.g:
+     \code
+     im.dim(0).specialize_extent(1920).dim(1).specialize_extent(1080);
+     \endcode
+     * constant-folds the indexing and removes vector tails for
+     * 1920x1080 inputs. */
+    // @{
+    EXPORT Dimension specialize_extent(Expr e);
+    EXPORT Dimension specialize_stride(Expr e);
+    // @}
+
     /** Get a different dimension of the same buffer */
     // @{
     EXPORT Dimension dim(int i);
@@ -1,5 +1,7 @@
 #include <algorithm>
+#include <chrono>
 #include <fstream>
+#include <future>
 
 #include "Pipeline.h"
 #include "Argument.h"
@@ -59,11 +61,21 @@ struct PipelineContents {
     JITModule jit_module;
     Target jit_target;
 
+    // If true, jit-compile quickly first, and build the optimized
+    // version on another thread.
+    bool tiered_jit;
+
+    // The optimized jit module being compiled in the background, if
+    // any. It replaces jit_module once it is ready.
+    std::future<JITModule> optimized_jit_module;
+
     /** Clear all cached state */
     void invalidate_cache() {
         module = Module("", Target());
         jit_module = JITModule();
         jit_target = Target();
+        // Note that this waits for any background compilation.
+        optimized_jit_module = std::future<JITModule>();
         inferred_args.clear();
     }
 
@@ -93,7 +105,7 @@ struct PipelineContents {
     std::map<std::string, JITExtern> jit_externs;
 
     PipelineContents() :
-        module("", Target()) {
+        module("", Target()), tiered_jit(false) {
         user_context_arg.arg = Argument("__user_context", Argument::InputScalar, type_of<const void*>(), 0);
         user_context_arg.param = Parameter(Handle(), false, 0, "__user_context",
                                            /*is_explicit_name*/ true, /*register_instance*/ false);
@@ -517,14 +529,20 @@ void *Pipeline::compile_jit(const Target &target_arg) {
     debug(2) << "jit-compiling for: " << target_arg.to_string() << "\n";
 
     // If we're re-jitting for the same target, we can just keep the
-    // old jit module.
+    // old jit module, unless the optimized version of it is done.
     if (contents->jit_target == target &&
         contents->jit_module.compiled()) {
+        if (contents->optimized_jit_module.valid() &&
+            contents->optimized_jit_module.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            debug(2) << "Switching to optimized jit module\n";
+            contents->jit_module = contents->optimized_jit_module.get();
+        }
         debug(2) << "Reusing old jit module compiled for :\n" << contents->jit_target.to_string() << "\n";
         return contents->jit_module.main_function();
     }
 
     contents->jit_target = target;
+    contents->optimized_jit_module = std::future<JITModule>();
 
     // Infer an arguments vector
     infer_arguments();
@@ -547,8 +565,32 @@ void *Pipeline::compile_jit(const Target &target_arg) {
 
     std::map<std::string, JITExtern> lowered_externs = contents->jit_externs;
 
+    std::vector<JITModule> externs_jit_module = make_externs_jit_module(target_arg, lowered_externs);
+
     // Compile to jit module
-    JITModule jit_module(module, f, make_externs_jit_module(target_arg, lowered_externs));
+    JITModule jit_module;
+    if (contents->tiered_jit && !target.has_feature(Target::FastCompile)) {
+        // Compile a version of the module quickly to use right away,
+        // and start building the optimized one. The lowered IR is
+        // shared; only LLVM codegen differs.
+        Module fast_module(module.name(), target.with_feature(Target::FastCompile));
+        for (const auto &b : module.buffers()) {
+            fast_module.append(b);
+        }
+        for (const auto &lf : module.functions()) {
+            fast_module.append(lf);
+        }
+        for (const auto &ec : module.external_code()) {
+            fast_module.append(ec);
+        }
+        jit_module = JITModule(fast_module, f, externs_jit_module);
+        contents->optimized_jit_module =
+            std::async(std::launch::async, [=]() {
+                return JITModule(module, f, externs_jit_module);
+            });
+    } else {
+        jit_module = JITModule(module, f, externs_jit_module);
+    }
 
     // Dump bitcode to a file if the environment variable
     // HL_GENBITCODE is defined to a nonzero value.
@@ -568,6 +610,14 @@ void *Pipeline::compile_jit(const Target &target_arg) {
 }
 
 
+void Pipeline::set_tiered_jit(bool tiered) {
+    user_assert(defined()) << "Pipeline is undefined\n";
+    if (contents->tiered_jit != tiered) {
+        contents->tiered_jit = tiered;
+        invalidate_cache();
+    }
+}
+
 void Pipeline::set_error_handler(void (*handler)(void *, const char *)) {
     user_assert(defined()) << "Pipeline is undefined\n";
     contents->jit_handlers.custom_error = handler;
@@ -1132,6 +1182,118 @@ void Pipeline::infer_input_bounds(int x_size, int y_size, int z_size, int w_size
     infer_input_bounds(r);
 }
 
+void Pipeline::realize_streaming(vector<int32_t> sizes, int strip_size,
+                                 StreamingReader reader, StreamingSink sink) {
+    user_assert(defined()) << "Can't realize an undefined Pipeline\n";
+    user_assert(!sizes.empty())
+        << "Can't stream the output of a zero-dimensional Pipeline\n";
+    user_assert(strip_size > 0)
+        << "Strip size for realize_streaming must be positive, not " << strip_size << "\n";
+    user_assert(reader && sink)
+        << "realize_streaming requires both a reader and a sink\n";
+
+    compile_jit(get_jit_target_from_environment());
+
+    // The inputs to stream are the ImageParams that aren't bound.
+    vector<Parameter> streamed;
+    for (const InferredArgument &arg : contents->inferred_args) {
+        if (arg.param.defined() && arg.param.is_buffer() &&
+            !arg.param.get_buffer().defined()) {
+            streamed.push_back(arg.param);
+        }
+    }
+
+    const int d = (int)sizes.size() - 1;
+    const int total = sizes[d];
+
+    // Output buffers for the strips. Full strips all share one set
+    // of allocations, and the final partial strip (if any) gets its
+    // own. Bounds queries use unallocated buffers of the same shape.
+    auto make_strip = [&](int extent, bool allocate) {
+        vector<int> shape(sizes.begin(), sizes.end());
+        shape[d] = extent;
+        vector<Buffer<>> bufs;
+        for (Function f : contents->outputs) {
+            for (Type t : f.output_types()) {
+                if (allocate) {
+                    bufs.emplace_back(t, shape);
+                } else {
+                    bufs.emplace_back(t, nullptr, shape);
+                }
+            }
+        }
+        return Realization(bufs);
+    };
+    auto move_strip = [&](Realization r, int min) {
+        for (size_t i = 0; i < r.size(); i++) {
+            r[i].translate(d, min - r[i].dim(d).min());
+        }
+    };
+
+    // Ask bounds inference what region of each streamed input the
+    // strip starting at the given coordinate needs, and allocate it.
+    auto query_inputs = [&](int min) {
+        Realization query = make_strip(std::min(strip_size, total - min), false);
+        move_strip(query, min);
+        for (Parameter &p : streamed) {
+            p.set_buffer(Buffer<>());
+        }
+        infer_input_bounds(query);
+        vector<Buffer<>> regions;
+        for (Parameter &p : streamed) {
+            regions.push_back(p.get_buffer());
+        }
+        return regions;
+    };
+
+    auto fetch_inputs = [&](vector<Buffer<>> regions) {
+        for (size_t i = 0; i < regions.size(); i++) {
+            reader(streamed[i].name(), regions[i]);
+        }
+    };
+
+    Realization full_strip = make_strip(std::min(strip_size, total), true);
+    vector<Buffer<>> current = query_inputs(0);
+    fetch_inputs(current);
+
+    for (int min = 0; min < total; min += strip_size) {
+        Realization strip = full_strip;
+        if (total - min < strip_size) {
+            strip = make_strip(total - min, true);
+        }
+        move_strip(strip, min);
+
+        // Start reading the input for the next strip while this one
+        // computes. Bounds queries touch the ImageParams, so they
+        // must happen on this thread before we bind the inputs for
+        // the current strip.
+        std::future<void> next_fetch;
+        vector<Buffer<>> next;
+        if (min + strip_size < total) {
+            next = query_inputs(min + strip_size);
+            next_fetch = std::async(std::launch::async, fetch_inputs, next);
+        }
+
+        for (size_t i = 0; i < streamed.size(); i++) {
+            streamed[i].set_buffer(current[i]);
+        }
+        realize(strip);
+        for (size_t i = 0; i < strip.size(); i++) {
+            strip[i].copy_to_host();
+        }
+        sink(strip);
+
+        if (next_fetch.valid()) {
+            next_fetch.get();
+        }
+        current = next;
+    }
+
+    for (Parameter &p : streamed) {
+        p.set_buffer(Buffer<>());
+    }
+}
+
 void Pipeline::invalidate_cache() {
     if (defined()) {
         contents->invalidate_cache();
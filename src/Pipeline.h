@@ -7,6 +7,7 @@
  * pipeline.
  */
 
+#include <functional>
 #include <vector>
 
 #include "AutoSchedule.h"
@@ -217,6 +218,17 @@ public:
      */
      EXPORT void *compile_jit(const Target &target = get_jit_target_from_environment());
 
+    /** Turn tiered jit compilation on or off. When on, compile_jit
+     * first generates code as quickly as possible (as if the target
+     * had the FastCompile feature), and then generates fully
+     * optimized code on a background thread. Calls to realize use
+     * the quickly-compiled code until the optimized code is ready,
+     * and then switch over to it. This greatly reduces the latency
+     * of the first call to realize, which matters for interactive
+     * use. Changing this setting invalidates any previously
+     * jit-compiled code. */
+    EXPORT void set_tiered_jit(bool tiered);
+
     /** Set the error handler function that be called in the case of
      * runtime errors during halide pipelines. If you are compiling
      * statically, you can also just define your own function with
@@ -392,6 +404,32 @@ public:
     EXPORT void infer_input_bounds(Realization dst);
     // @}
 
+    /** A callback used by realize_streaming to fill in a region of an
+     * input. It is passed the name of the ImageParam and an allocated
+     * Buffer whose min and extents give the region required. */
+    typedef std::function<void(const std::string &, Buffer<>)> StreamingReader;
+
+    /** A callback used by realize_streaming to consume one strip of
+     * the output. The Buffers in the Realization are reused for the
+     * next strip, so the sink must be done with them by the time it
+     * returns. */
+    typedef std::function<void(Realization)> StreamingSink;
+
+    /** Evaluate this Pipeline over an output of the given size
+     * without ever holding the whole output, or the whole input, in
+     * memory. The output is split into strips of strip_size along
+     * its outermost dimension. For each strip, bounds inference
+     * determines the region required of every ImageParam that is
+     * not currently bound, the reader is called to fill in just that
+     * region, the strip is realized, and then handed to the
+     * sink. The reader for the next strip runs on another thread
+     * while the current strip is being computed, so the thread pool
+     * is not left idle waiting on I/O. Strips are produced in order
+     * of increasing coordinate. Unbound ImageParams are left unbound
+     * on return. */
+    EXPORT void realize_streaming(std::vector<int32_t> sizes, int strip_size,
+                                  StreamingReader reader, StreamingSink sink);
+
     /** Infer the arguments to the Pipeline, sorted into a canonical order:
      * all buffers (sorted alphabetically by name), followed by all non-buffers
      * (sorted alphabetically by name).
@@ -31,6 +31,8 @@ const Definition &get_stage_definition(const Function &f, int stage_num) {
 class CollectExternalBufferBounds : public IRVisitor {
 public:
     map<string, Box> buffers;
+    // The input image parameters loaded from.
+    map<string, Parameter> inputs;
 
     using IRVisitor::visit;
 
@@ -51,6 +53,9 @@ public:
     void visit(const Call *op) {
         IRVisitor::visit(op);
         add_buffer_bounds(op->name, op->image, op->param, (int)op->args.size());
+        if (op->call_type == Call::Image && op->param.defined()) {
+            inputs.emplace(op->name, op->param);
+        }
     }
 
     void visit(const Variable *op) {
@@ -60,14 +65,39 @@ public:
     }
 };
 
+// Find the depth of the deepest nest of serial loops in a stmt.
+class SerialLoopDepth : public IRVisitor {
+    using IRVisitor::visit;
+
+    int depth = 0;
+
+    void visit(const For *op) {
+        if (op->for_type == ForType::Serial) {
+            depth++;
+            result = std::max(result, depth);
+            IRVisitor::visit(op);
+            depth--;
+        } else {
+            IRVisitor::visit(op);
+        }
+    }
+
+public:
+    int result = 0;
+};
+
 class InjectPrefetch : public IRMutator {
 public:
-    InjectPrefetch(const map<string, Function> &e, const map<string, Box> &buffers)
-        : env(e), external_buffers(buffers), current_func(nullptr), stage(-1) { }
+    InjectPrefetch(const map<string, Function> &e, const map<string, Box> &buffers,
+                   const map<string, Parameter> &inputs, bool auto_prefetch)
+        : env(e), external_buffers(buffers), inputs(inputs), auto_prefetch(auto_prefetch),
+          current_func(nullptr), stage(-1) { }
 
 private:
     const map<string, Function> &env;
     const map<string, Box> &external_buffers;
+    const map<string, Parameter> &inputs;
+    bool auto_prefetch;
     const Function *current_func;
     int stage;
     Scope<Interval> scope;
@@ -192,7 +222,7 @@ private:
         }
     }
 
-    Stmt add_prefetch(string buf_name, const Parameter &param, const Box &box, Stmt body) {
+    Stmt add_prefetch(string buf_name, const Parameter &param, PrefetchHint hint, const Box &box, Stmt body) {
         // Construct the region to be prefetched.
         Region bounds;
         for (size_t i = 0; i < box.size(); i++) {
@@ -202,11 +232,11 @@ private:
 
         Stmt prefetch;
         if (param.defined()) {
-            prefetch = Prefetch::make(buf_name, {param.type()}, bounds, param);
+            prefetch = Prefetch::make(buf_name, {param.type()}, bounds, param, hint);
         } else {
             const auto &it = env.find(buf_name);
             internal_assert(it != env.end());
-            prefetch = Prefetch::make(buf_name, it->second.output_types(), bounds);
+            prefetch = Prefetch::make(buf_name, it->second.output_types(), bounds, Parameter(), hint);
         }
 
         if (box.maybe_unused()) {
@@ -219,7 +249,7 @@ private:
         const Function *old_func = current_func;
         int old_stage = stage;
 
-        const vector<PrefetchDirective> &prefetch_list = get_prefetch_list(op->name);
+        vector<PrefetchDirective> prefetch_list = get_prefetch_list(op->name);
 
         // Add loop variable to interval scope for any inner loop prefetch
         Expr loop_var = Variable::make(Int(32), op->name);
@@ -227,6 +257,35 @@ private:
         Stmt body = mutate(op->body);
         scope.pop(op->name);
 
+        // Automatically prefetch the next iteration's inputs in loops
+        // whose body is a single level of serial loops (typically the
+        // loop over tiles or rows), unless the schedule already says
+        // how to prefetch them. The directives go first, so that
+        // explicit ones for this loop take precedence.
+        set<string> automatic;
+        if (auto_prefetch &&
+            op->for_type == ForType::Serial &&
+            op->device_api == DeviceAPI::None) {
+            SerialLoopDepth depth;
+            body.accept(&depth);
+            if (depth.result == 1) {
+                set<string> scheduled;
+                for (const PrefetchDirective &p : prefetch_list) {
+                    scheduled.insert(p.name);
+                }
+                string var = op->name.substr(op->name.rfind('.') + 1);
+                vector<PrefetchDirective> auto_list;
+                for (const auto &in : inputs) {
+                    if (!scheduled.count(in.first)) {
+                        auto_list.push_back({in.first, var, 1, PrefetchBoundStrategy::Clamp,
+                                             in.second, PrefetchHint::Read});
+                        automatic.insert(in.first);
+                    }
+                }
+                prefetch_list.insert(prefetch_list.begin(), auto_list.begin(), auto_list.end());
+            }
+        }
+
         if (!prefetch_list.empty()) {
             // If there are multiple prefetches of the same Func or ImageParam,
             // use the most recent one
@@ -252,6 +311,24 @@ private:
                 // that shifts the base address of the prefetched box so that
                 // the box is completely within the bounds.
                 const auto &b = boxes_rw.find(p.name);
+                if (b != boxes_rw.end() && automatic.count(p.name)) {
+                    // Only prefetch boxes we can bound that span more
+                    // than one row; the hardware prefetchers already
+                    // handle streaming along a single row.
+                    bool multi_row = false;
+                    for (size_t i = 0; i < b->second.size(); i++) {
+                        if (!b->second[i].is_bounded()) {
+                            multi_row = false;
+                            break;
+                        }
+                        if (i > 0 && !is_one(simplify(b->second[i].max - b->second[i].min + 1))) {
+                            multi_row = true;
+                        }
+                    }
+                    if (!multi_row) {
+                        continue;
+                    }
+                }
                 if (b != boxes_rw.end()) {
                     Box prefetch_box = b->second;
                     // Only prefetch the region that is in bounds.
@@ -272,7 +349,7 @@ private:
                         // Assume the prefetch won't fault when accessing region
                         // outside the bounds.
                     }
-                    body = add_prefetch(b->first, p.param, prefetch_box, body);
+                    body = add_prefetch(b->first, p.param, p.hint, prefetch_box, body);
                 }
             }
         }
@@ -306,14 +383,14 @@ class ReducePrefetchDimension : public IRMutator {
         // the dimensions with larger strides and keep the smaller ones in
         // the prefetch call.
 
-        size_t max_arg_size = 2 + 2 * max_dim; // Prefetch: {base, offset, extent0, stride0, extent1, stride1, ...}
-        if (call && call->is_intrinsic(Call::prefetch) && (call->args.size() > max_arg_size)) {
+        size_t max_arg_size = 2 + 2 * max_dim; // Prefetch: {base, offset, extent0, stride0, extent1, stride1, ..., hint}
+        if (call && call->is_intrinsic(Call::prefetch) && (call->args.size() - 1 > max_arg_size)) {
             const Variable *base = call->args[0].as<Variable>();
             internal_assert(base && base->type.is_handle());
 
             vector<string> index_names;
             Expr new_offset = call->args[1];
-            for (size_t i = max_arg_size; i < call->args.size(); i += 2) {
+            for (size_t i = max_arg_size; i < call->args.size() - 1; i += 2) {
                 Expr stride = call->args[i+1];
                 string index_name = "prefetch_reduce_" + base->name + "." + std::to_string((i-1)/2);
                 index_names.push_back(index_name);
@@ -324,6 +401,7 @@ class ReducePrefetchDimension : public IRMutator {
             for (size_t i = 2; i < max_arg_size; ++i) {
                 args.push_back(call->args[i]);
             }
+            args.push_back(call->args.back());
 
             stmt = Evaluate::make(Call::make(call->type, Call::prefetch, args, Call::Intrinsic));
             for (size_t i = 0; i < index_names.size(); ++i) {
@@ -357,12 +435,13 @@ class SplitPrefetch : public IRMutator {
             const Variable *base = call->args[0].as<Variable>();
             internal_assert(base && base->type.is_handle());
 
-            int elem_size = base->type.bytes();
+            // The offset and strides are in elements of the prefetched type.
+            int elem_size = call->type.bytes();
 
             vector<string> index_names;
             vector<Expr> extents;
             Expr new_offset = call->args[1];
-            for (size_t i = 2; i < call->args.size(); i += 2) {
+            for (size_t i = 2; i < call->args.size() - 1; i += 2) {
                 Expr extent = call->args[i];
                 Expr stride = call->args[i+1];
                 Expr stride_bytes = stride * elem_size;
@@ -377,17 +456,18 @@ class SplitPrefetch : public IRMutator {
                     // If 'max_byte_size' is smaller than the absolute value of the
                     // stride bytes, we can only prefetch one element per iteration.
                     outer_extent = extent;
-                    new_offset += outer_var * stride_bytes;
+                    new_offset += outer_var * stride;
                 } else {
                     // Otherwise, we just prefetch 'max_byte_size' per iteration.
                     Expr abs_stride_bytes = Call::make(stride_bytes.type(), Call::abs, {stride_bytes}, Call::PureIntrinsic);
+                    Expr max_elems = max_byte_size / elem_size;
                     outer_extent = simplify((extent * abs_stride_bytes + max_byte_size - 1)/max_byte_size);
-                    new_offset += outer_var * simplify(select(is_negative_stride, -max_byte_size, max_byte_size));
+                    new_offset += outer_var * simplify(select(is_negative_stride, -max_elems, max_elems));
                 }
                 extents.push_back(outer_extent);
             }
 
-            vector<Expr> args = {base, new_offset, Expr(1), simplify(max_byte_size / elem_size)};
+            vector<Expr> args = {base, new_offset, Expr(1), simplify(max_byte_size / elem_size), call->args.back()};
             stmt = Evaluate::make(Call::make(call->type, Call::prefetch, args, Call::Intrinsic));
             for (size_t i = 0; i < index_names.size(); ++i) {
                 stmt = For::make(index_names[i], 0, extents[i],
@@ -404,10 +484,10 @@ public:
 
 } // anonymous namespace
 
-Stmt inject_prefetch(Stmt s, const map<string, Function> &env) {
+Stmt inject_prefetch(Stmt s, const map<string, Function> &env, const Target &t) {
     CollectExternalBufferBounds finder;
     s.accept(&finder);
-    return InjectPrefetch(env, finder.buffers).mutate(s);
+    return InjectPrefetch(env, finder.buffers, finder.inputs, t.has_feature(Target::AutoPrefetch)).mutate(s);
 }
 
 Stmt reduce_prefetch_dimension(Stmt stmt, const Target &t) {
@@ -14,7 +14,12 @@
 namespace Halide {
 namespace Internal {
 
-Stmt inject_prefetch(Stmt s, const std::map<std::string, Function> &env);
+/** Inject Prefetch nodes for the prefetch directives in the
+ * schedule. If the target has the auto_prefetch feature, also
+ * prefetch the next iteration's region of each input image parameter
+ * in loops over tiles or rows that don't already have a directive for
+ * that input. */
+Stmt inject_prefetch(Stmt s, const std::map<std::string, Function> &env, const Target &t);
 
 /** Reduce a multi-dimensional prefetch into a prefetch of lower dimension
  * (max dimension of the prefetch is specified by target architecture).
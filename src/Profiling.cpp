@@ -1,5 +1,7 @@
 #include <algorithm>
+#include <fstream>
 #include <map>
+#include <sstream>
 #include <string>
 #include <limits>
 
@@ -262,6 +264,143 @@ private:
     }
 };
 
+namespace {
+
+// Visits the branches in host code in a fixed order, so that branch
+// counts collected from an instrumented build can be matched up with
+// the branches of a later build with the same schedule.
+class BranchMutator : public IRMutator {
+protected:
+    int next_branch = 0;
+
+    using IRMutator::visit;
+
+    virtual Stmt mutate_branch(const IfThenElse *op, int id, Stmt then_case, Stmt else_case) = 0;
+
+    void visit(const For *op) {
+        if (op->device_api != DeviceAPI::None &&
+            op->device_api != DeviceAPI::Host) {
+            // Leave device code alone.
+            stmt = op;
+        } else {
+            IRMutator::visit(op);
+        }
+    }
+
+    void visit(const IfThenElse *op) {
+        int id = next_branch++;
+        Stmt then_case = mutate(op->then_case);
+        Stmt else_case = mutate(op->else_case);
+        stmt = mutate_branch(op, id, then_case, else_case);
+    }
+
+public:
+    int num_branches() const {
+        return next_branch;
+    }
+};
+
+// Counters 2*i and 2*i + 1 track how often branch i goes each way.
+class InjectBranchCounters : public BranchMutator {
+    Stmt count(int idx) {
+        Expr counters = Variable::make(Handle(), "profiler_counters");
+        return Evaluate::make(Call::make(Int(32), "halide_profiler_incr_counter",
+                                         {counters, idx}, Call::Extern));
+    }
+
+    Stmt mutate_branch(const IfThenElse *op, int id, Stmt then_case, Stmt else_case) override {
+        then_case = Block::make(count(2 * id), then_case);
+        if (else_case.defined()) {
+            else_case = Block::make(count(2 * id + 1), else_case);
+        } else {
+            else_case = count(2 * id + 1);
+        }
+        return IfThenElse::make(op->condition, then_case, else_case);
+    }
+};
+
+class ApplyBranchProfile : public BranchMutator {
+    const vector<uint64_t> &counts;
+
+    Stmt mutate_branch(const IfThenElse *op, int id, Stmt then_case, Stmt else_case) override {
+        if (2 * id + 1 >= (int)counts.size()) {
+            // The profile doesn't match. The caller will notice.
+            return IfThenElse::make(op->condition, then_case, else_case);
+        }
+        uint64_t taken = counts[2 * id], not_taken = counts[2 * id + 1];
+        uint64_t total = taken + not_taken;
+        // Only mark branches that go the same way at least 90% of the time.
+        if (total > 0 && taken * 10 >= total * 9) {
+            debug(3) << "Branch " << id << " is likely taken: " << taken << "/" << total << "\n";
+            return IfThenElse::make(likely(op->condition), then_case, else_case);
+        } else if (total > 0 && not_taken * 10 >= total * 9) {
+            debug(3) << "Branch " << id << " is likely not taken: " << not_taken << "/" << total << "\n";
+            if (!else_case.defined()) {
+                else_case = Evaluate::make(0);
+            }
+            return IfThenElse::make(likely(!op->condition), else_case, then_case);
+        } else {
+            return IfThenElse::make(op->condition, then_case, else_case);
+        }
+    }
+
+public:
+    ApplyBranchProfile(const vector<uint64_t> &counts) : counts(counts) {}
+};
+
+// Find the branch counts for a pipeline in a branch profile. Each
+// line is the pipeline name, the number of counters, and then the
+// counters.
+bool load_branch_profile(const string &filename, const string &pipeline_name,
+                         vector<uint64_t> &counts) {
+    std::ifstream file(filename);
+    string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        string name;
+        size_t n = 0;
+        fields >> name >> n;
+        if (name != pipeline_name) continue;
+        counts.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            fields >> counts[i];
+        }
+        return !fields.fail();
+    }
+    return false;
+}
+
+}  // namespace
+
+Stmt inject_branch_counters(Stmt s, const string &pipeline_name) {
+    InjectBranchCounters injector;
+    s = injector.mutate(s);
+    int num_counters = injector.num_branches() * 2;
+    if (num_counters == 0) {
+        return s;
+    }
+    Expr get_counters = Call::make(Handle(), "halide_profiler_get_counters",
+                                   {pipeline_name, num_counters}, Call::Extern);
+    return LetStmt::make("profiler_counters", get_counters, s);
+}
+
+Stmt apply_branch_profile(Stmt s, const string &pipeline_name) {
+    string filename = get_env_variable("HL_BRANCH_PROFILE");
+    vector<uint64_t> counts;
+    if (filename.empty() || !load_branch_profile(filename, pipeline_name, counts)) {
+        return s;
+    }
+    ApplyBranchProfile applier(counts);
+    Stmt result = applier.mutate(s);
+    if ((size_t)applier.num_branches() * 2 != counts.size()) {
+        user_warning << "Ignoring the branch profile for " << pipeline_name
+                     << " in " << filename << ", because it was collected"
+                     << " from a pipeline with a different schedule.\n";
+        return s;
+    }
+    return result;
+}
+
 Stmt inject_profiling(Stmt s, string pipeline_name) {
     InjectProfiling profiling(pipeline_name);
     s = profiling.mutate(s);
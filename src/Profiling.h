@@ -38,6 +38,23 @@ namespace Internal {
  */
 Stmt inject_profiling(Stmt, std::string);
 
+/** Count how many times each side of each branch on the host is
+ * taken. Used with Target::Profile, when the environment variable
+ * HL_BRANCH_PROFILE is set. The counts are written to the file it
+ * names when the profiler reports. The counters add an atomic
+ * increment to every branch, so the per-Func timings of a build with
+ * them aren't comparable to one without. Should be done at the very
+ * end of lowering. */
+Stmt inject_branch_counters(Stmt, const std::string &pipeline_name);
+
+/** Read the branch counts for this pipeline from the file named by
+ * HL_BRANCH_PROFILE, if any, and mark the branches that almost
+ * always go one way as likely to do so, for the benefit of
+ * codegen. The Stmt must be lowered for the same schedule as when
+ * the counts were collected. Should be done at the same point in
+ * lowering as inject_branch_counters. */
+Stmt apply_branch_profile(Stmt, const std::string &pipeline_name);
+
 }
 }
 
@@ -0,0 +1,350 @@
+#include "PythonExtensionGen.h"
+#include "Util.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::string;
+using std::vector;
+
+namespace {
+
+// Everything the extension module needs that doesn't depend on the
+// Module being wrapped.
+const char *python_extension_prelude = R"INLINE_CODE(
+#include <Python.h>
+#include <string.h>
+#include <vector>
+
+#include "HalideRuntime.h"
+
+namespace {
+
+const char *skip_byte_order(const char *format) {
+    if (format == nullptr) {
+        return "B";
+    }
+    if (*format == '@' || *format == '=' || *format == '<') {
+        format++;
+    }
+    return format;
+}
+
+bool format_matches(const char *format, Py_ssize_t itemsize, halide_type_t t) {
+    format = skip_byte_order(format);
+    if (format[0] == 0 || format[1] != 0) {
+        return false;
+    }
+    if (t.code == halide_type_uint && t.bits == 1) {
+        return itemsize == 1 && (format[0] == '?' || format[0] == 'B');
+    }
+    if (itemsize * 8 != t.bits) {
+        return false;
+    }
+    switch (t.code) {
+    case halide_type_int:
+        return strchr("bhilq", format[0]) != nullptr;
+    case halide_type_uint:
+        return strchr("BHILQ", format[0]) != nullptr;
+    case halide_type_float:
+        return strchr("efd", format[0]) != nullptr;
+    default:
+        return false;
+    }
+}
+
+// Describe the memory of an object supporting the buffer protocol
+// with a halide_buffer_t, without copying. Dimension i of the buffer
+// is axis i of the object.
+int unpack_buffer(PyObject *obj, const halide_filter_argument_t *arg,
+                  Py_buffer *view, halide_buffer_t *buf, std::vector<halide_dimension_t> *dims) {
+    const int flags = arg->kind == halide_argument_kind_output_buffer ? PyBUF_RECORDS : PyBUF_RECORDS_RO;
+    if (PyObject_GetBuffer(obj, view, flags) != 0) {
+        return -1;
+    }
+    if (view->ndim != arg->dimensions) {
+        PyErr_Format(PyExc_ValueError, "Argument %s should have %d dimensions, but has %d",
+                     arg->name, arg->dimensions, view->ndim);
+        PyBuffer_Release(view);
+        return -1;
+    }
+    if (!format_matches(view->format, view->itemsize, arg->type)) {
+        PyErr_Format(PyExc_ValueError, "Argument %s has the wrong element type (format '%s', %d bytes)",
+                     arg->name, skip_byte_order(view->format), (int)view->itemsize);
+        PyBuffer_Release(view);
+        return -1;
+    }
+    dims->resize(view->ndim);
+    for (int i = 0; i < view->ndim; i++) {
+        if (view->strides[i] % view->itemsize != 0) {
+            PyErr_Format(PyExc_ValueError, "Argument %s has a stride that isn't a multiple of the element size",
+                         arg->name);
+            PyBuffer_Release(view);
+            return -1;
+        }
+        (*dims)[i].min = 0;
+        (*dims)[i].extent = (int32_t)view->shape[i];
+        (*dims)[i].stride = (int32_t)(view->strides[i] / view->itemsize);
+        (*dims)[i].flags = 0;
+    }
+    *buf = halide_buffer_t();
+    buf->host = (uint8_t *)view->buf;
+    buf->type = arg->type;
+    buf->dimensions = view->ndim;
+    buf->dim = dims->data();
+    return 0;
+}
+
+int unpack_scalar(PyObject *obj, const halide_filter_argument_t *arg, halide_scalar_value_t *v) {
+    const halide_type_t t = arg->type;
+    if (t.code == halide_type_handle) {
+        v->u.handle = obj == Py_None ? nullptr : PyLong_AsVoidPtr(obj);
+    } else if (t.code == halide_type_float) {
+        double d = PyFloat_AsDouble(obj);
+        if (t.bits == 32) {
+            v->u.f32 = (float)d;
+        } else {
+            v->u.f64 = d;
+        }
+    } else if (t.code == halide_type_uint && t.bits == 1) {
+        int b = PyObject_IsTrue(obj);
+        if (b < 0) {
+            return -1;
+        }
+        v->u.b = b != 0;
+    } else if (t.code == halide_type_int) {
+        long long x = PyLong_AsLongLong(obj);
+        if (t.bits < 64 && (x < -(1LL << (t.bits - 1)) || x >= (1LL << (t.bits - 1)))) {
+            PyErr_Format(PyExc_OverflowError, "Argument %s is out of range", arg->name);
+            return -1;
+        }
+        switch (t.bits) {
+        case 8: v->u.i8 = (int8_t)x; break;
+        case 16: v->u.i16 = (int16_t)x; break;
+        case 32: v->u.i32 = (int32_t)x; break;
+        default: v->u.i64 = x; break;
+        }
+    } else {
+        unsigned long long x = PyLong_AsUnsignedLongLong(obj);
+        if (t.bits < 64 && x >= (1ULL << t.bits) && x != (unsigned long long)-1) {
+            PyErr_Format(PyExc_OverflowError, "Argument %s is out of range", arg->name);
+            return -1;
+        }
+        switch (t.bits) {
+        case 8: v->u.u8 = (uint8_t)x; break;
+        case 16: v->u.u16 = (uint16_t)x; break;
+        case 32: v->u.u32 = (uint32_t)x; break;
+        default: v->u.u64 = x; break;
+        }
+    }
+    return PyErr_Occurred() ? -1 : 0;
+}
+
+bool is_user_context(const halide_filter_argument_t *arg) {
+    return arg->kind == halide_argument_kind_input_scalar &&
+           arg->type.code == halide_type_handle &&
+           strcmp(arg->name, "__user_context") == 0;
+}
+
+// Call a pipeline through its argv entry point, matching Python
+// arguments to pipeline arguments using the metadata. The user
+// context, if any, may be omitted.
+PyObject *call_pipeline(int (*argv_fn)(void **), const halide_filter_metadata_t *md,
+                        PyObject *args, PyObject *kwargs) {
+    const int n = md->num_arguments;
+    std::vector<PyObject *> py_args(n, nullptr);
+
+    Py_ssize_t next_positional = 0, num_positional = PyTuple_Size(args);
+    Py_ssize_t kwargs_used = 0;
+    for (int i = 0; i < n; i++) {
+        const halide_filter_argument_t *arg = &md->arguments[i];
+        PyObject *kw = kwargs ? PyDict_GetItemString(kwargs, arg->name) : nullptr;
+        if (kw) {
+            py_args[i] = kw;
+            kwargs_used++;
+        } else if (is_user_context(arg)) {
+            py_args[i] = Py_None;
+        } else if (next_positional < num_positional) {
+            py_args[i] = PyTuple_GetItem(args, next_positional++);
+        } else {
+            PyErr_Format(PyExc_TypeError, "%s() missing argument %s", md->name, arg->name);
+            return nullptr;
+        }
+    }
+    if (next_positional < num_positional || (kwargs && kwargs_used < PyDict_Size(kwargs))) {
+        PyErr_Format(PyExc_TypeError, "%s() got unexpected arguments", md->name);
+        return nullptr;
+    }
+
+    std::vector<Py_buffer> views(n);
+    std::vector<bool> have_view(n, false);
+    std::vector<halide_buffer_t> buffers(n);
+    std::vector<std::vector<halide_dimension_t>> dims(n);
+    std::vector<halide_scalar_value_t> scalars(n);
+    std::vector<void *> argv(n);
+
+    int error = 0;
+    for (int i = 0; i < n && error == 0; i++) {
+        const halide_filter_argument_t *arg = &md->arguments[i];
+        if (arg->kind == halide_argument_kind_input_scalar) {
+            error = unpack_scalar(py_args[i], arg, &scalars[i]);
+            argv[i] = &scalars[i];
+        } else {
+            error = unpack_buffer(py_args[i], arg, &views[i], &buffers[i], &dims[i]);
+            have_view[i] = (error == 0);
+            argv[i] = &buffers[i];
+        }
+    }
+
+    int result = 0;
+    if (error == 0) {
+        Py_BEGIN_ALLOW_THREADS
+        result = argv_fn(argv.data());
+        Py_END_ALLOW_THREADS
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (have_view[i]) {
+            PyBuffer_Release(&views[i]);
+        }
+    }
+
+    if (error != 0) {
+        return nullptr;
+    }
+    if (result != 0) {
+        PyErr_Format(PyExc_RuntimeError, "Halide pipeline %s failed with error code %d", md->name, result);
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+// Describe the arguments of a pipeline as a tuple of (name, kind,
+// dimensions, type) tuples.
+PyObject *describe_arguments(const halide_filter_metadata_t *md) {
+    static const char *kinds[] = {"input_scalar", "input_buffer", "output_buffer"};
+    static const char *codes[] = {"int", "uint", "float", "handle"};
+    PyObject *result = PyTuple_New(md->num_arguments);
+    for (int i = 0; i < md->num_arguments; i++) {
+        const halide_filter_argument_t *arg = &md->arguments[i];
+        PyObject *type = PyUnicode_FromFormat("%s%d", codes[arg->type.code], arg->type.bits);
+        PyTuple_SetItem(result, i, Py_BuildValue("(ssiN)", arg->name, kinds[arg->kind],
+                                                 arg->dimensions, type));
+    }
+    return result;
+}
+
+)INLINE_CODE";
+
+}  // namespace
+
+PythonExtensionGen::PythonExtensionGen(std::ostream &dest) : dest(dest) {
+}
+
+void PythonExtensionGen::compile(const Module &module) {
+    vector<string> module_namespaces;
+    const string module_name = extract_namespaces(module.name(), module_namespaces);
+    const bool cplusplus = module.target().has_feature(Target::CPlusPlusMangling);
+
+    vector<const LoweredFunc *> funcs;
+    for (const auto &f : module.functions()) {
+        if (f.linkage == LoweredFunc::ExternalPlusMetadata) {
+            funcs.push_back(&f);
+        }
+    }
+    user_assert(!funcs.empty())
+        << "Module " << module.name() << " has no functions with metadata to wrap in a Python extension.\n";
+
+    dest << "// Python extension module for " << module.name() << ", generated by Halide.\n"
+         << "// Build it against the compiled pipeline with e.g.\n"
+         << "//   c++ -shared -fPIC -I<halide>/include $(python3-config --includes) \\\n"
+         << "//       this_file.cpp " << module_name << ".a -o " << module_name << "$(python3-config --extension-suffix)\n"
+         << python_extension_prelude;
+
+    // Declare the entry points. They have C++ linkage if the
+    // pipeline was compiled with C++ name mangling.
+    dest << "}  // namespace\n\n";
+    if (!cplusplus) {
+        dest << "extern \"C\" {\n";
+    }
+    for (const LoweredFunc *f : funcs) {
+        vector<string> namespaces;
+        string simple_name = extract_namespaces(f->name, namespaces);
+        if (cplusplus) {
+            for (const auto &ns : namespaces) {
+                dest << "namespace " << ns << " { ";
+            }
+        }
+        dest << "int " << simple_name << "_argv(void **args); "
+             << "const struct halide_filter_metadata_t *" << simple_name << "_metadata();";
+        if (cplusplus) {
+            for (size_t i = 0; i < namespaces.size(); i++) {
+                dest << " }";
+            }
+        }
+        dest << "\n";
+    }
+    if (!cplusplus) {
+        dest << "}  // extern \"C\"\n";
+    }
+
+    dest << "\nnamespace {\n\n";
+    for (const LoweredFunc *f : funcs) {
+        vector<string> namespaces;
+        string simple_name = extract_namespaces(f->name, namespaces);
+        string qualified_name = cplusplus ? "::" + f->name : simple_name;
+        dest << "PyObject *call_" << simple_name << "(PyObject *, PyObject *args, PyObject *kwargs) {\n"
+             << "    return call_pipeline(" << qualified_name << "_argv, "
+             << qualified_name << "_metadata(), args, kwargs);\n"
+             << "}\n\n";
+    }
+
+    dest << "PyMethodDef methods[] = {\n";
+    for (const LoweredFunc *f : funcs) {
+        vector<string> namespaces;
+        string simple_name = extract_namespaces(f->name, namespaces);
+        string signature;
+        for (const auto &arg : f->args) {
+            if (arg.name == "__user_context") {
+                continue;
+            }
+            if (!signature.empty()) {
+                signature += ", ";
+            }
+            signature += arg.name;
+        }
+        dest << "    {\"" << simple_name << "\", (PyCFunction)(void (*)(void))call_" << simple_name
+             << ", METH_VARARGS | METH_KEYWORDS,\n"
+             << "     \"" << simple_name << "(" << signature << ")\\n\\n"
+             << "Run the Halide pipeline " << f->name << ". Buffers may be any objects "
+             << "supporting the buffer protocol, and are not copied.\"},\n";
+    }
+    dest << "    {nullptr, nullptr, 0, nullptr}\n"
+         << "};\n\n"
+         << "PyModuleDef module_def = {\n"
+         << "    PyModuleDef_HEAD_INIT, \"" << module_name << "\", nullptr, -1, methods\n"
+         << "};\n\n"
+         << "}  // namespace\n\n";
+
+    // Also expose the metadata of each function, as
+    // <name>_arguments and <name>_target.
+    dest << "PyMODINIT_FUNC PyInit_" << module_name << "() {\n"
+         << "    PyObject *m = PyModule_Create(&module_def);\n"
+         << "    if (m == nullptr) {\n"
+         << "        return nullptr;\n"
+         << "    }\n";
+    for (const LoweredFunc *f : funcs) {
+        vector<string> namespaces;
+        string simple_name = extract_namespaces(f->name, namespaces);
+        string qualified_name = cplusplus ? "::" + f->name : simple_name;
+        dest << "    PyModule_AddObject(m, \"" << simple_name << "_arguments\", describe_arguments("
+             << qualified_name << "_metadata()));\n"
+             << "    PyModule_AddStringConstant(m, \"" << simple_name << "_target\", "
+             << qualified_name << "_metadata()->target);\n";
+    }
+    dest << "    return m;\n"
+         << "}\n";
+}
+
+}  // namespace Internal
+}  // namespace Halide
@@ -0,0 +1,40 @@
+#ifndef HALIDE_PYTHON_EXTENSION_GEN_H_
+#define HALIDE_PYTHON_EXTENSION_GEN_H_
+
+/** \file
+ *
+ * Defines an emitter for the source of a Python extension module
+ * wrapping the entry points of an ahead-of-time compiled Module.
+ */
+
+#include <iostream>
+#include <string>
+
+#include "Module.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Emits C++ source for a CPython extension module with one Python
+ * function per externally-visible function in a Module with
+ * metadata. Each Python function takes its arguments in order (or by
+ * name), accepts any object supporting the buffer protocol
+ * (e.g. numpy arrays) for buffer arguments without copying, releases
+ * the GIL while the pipeline runs, and raises a RuntimeError if the
+ * pipeline returns an error. The source only depends on
+ * HalideRuntime.h and the Python headers, so it can be built against
+ * a static library of the Module without libHalide. */
+class PythonExtensionGen {
+public:
+    PythonExtensionGen(std::ostream &dest);
+
+    void compile(const Module &module);
+
+private:
+    std::ostream &dest;
+};
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
@@ -44,16 +44,22 @@ class RemoveDeadAllocations : public IRMutator {
     }
 
     void visit(const Allocate *op) {
+        // The new expression may point into another allocation.
+        Expr new_expr;
+        if (op->new_expr.defined()) {
+            new_expr = mutate(op->new_expr);
+        }
+
         allocs.push(op->name, 1);
         Stmt body = mutate(op->body);
 
         if (allocs.contains(op->name) && op->free_function.empty()) {
             stmt = body;
             allocs.pop(op->name);
-        } else if (body.same_as(op->body)) {
+        } else if (body.same_as(op->body) && new_expr.same_as(op->new_expr)) {
             stmt = op;
         } else {
-            stmt = Allocate::make(op->name, op->type, op->extents, op->condition, body, op->new_expr, op->free_function);
+            stmt = Allocate::make(op->name, op->type, op->extents, op->condition, body, new_expr, op->free_function);
         }
     }
 
@@ -125,11 +125,11 @@ struct FuncScheduleContents {
     std::vector<Bound> bounds;
     std::vector<Bound> estimates;
     std::map<std::string, Internal::FunctionPtr> wrappers;
-    bool memoized;
+    bool memoized, persistent, non_temporal_stores;
 
     FuncScheduleContents() :
         store_level(LoopLevel::inlined()), compute_level(LoopLevel::inlined()),
-        memoized(false) {};
+        memoized(false), persistent(false), non_temporal_stores(false) {};
 
     // Pass an IRMutator through to all Exprs referenced in the FuncScheduleContents
     void mutate(IRMutator *mutator) {
@@ -236,6 +236,8 @@ FuncSchedule FuncSchedule::deep_copy(
     copy.contents->bounds = contents->bounds;
     copy.contents->estimates = contents->estimates;
     copy.contents->memoized = contents->memoized;
+    copy.contents->persistent = contents->persistent;
+    copy.contents->non_temporal_stores = contents->non_temporal_stores;
 
     // Deep-copy wrapper functions.
     for (const auto &iter : contents->wrappers) {
@@ -255,6 +257,22 @@ bool FuncSchedule::memoized() const {
     return contents->memoized;
 }
 
+bool &FuncSchedule::persistent() {
+    return contents->persistent;
+}
+
+bool FuncSchedule::persistent() const {
+    return contents->persistent;
+}
+
+bool &FuncSchedule::non_temporal_stores() {
+    return contents->non_temporal_stores;
+}
+
+bool FuncSchedule::non_temporal_stores() const {
+    return contents->non_temporal_stores;
+}
+
 std::vector<StorageDim> &FuncSchedule::storage_dims() {
     return contents->storage_dims;
 }
@@ -63,6 +63,18 @@ enum class TailStrategy {
      * instead of a multiple of the split factor as with RoundUp. */
     ShiftInwards,
 
+    /** Like GuardWithIf, but if the inner loop is vectorized, the
+     * tail case stays vectorized using masked loads and stores
+     * instead of being scalarized, on targets that have them
+     * (AVX-512 for all lane sizes with AVX-512BW, AVX for 32- and
+     * 64-bit lanes, and HVX). Always legal. Pros: no redundant
+     * re-evaluation; does not constrain input or output sizes; no
+     * scalar epilogue, which is significant for narrow images and
+     * small tiles. Cons: masked memory operations are slower than
+     * regular ones on some targets; on other targets, or if the
+     * loop body has side effects, this behaves like GuardWithIf. */
+    Predicate,
+
     /** For pure definitions use ShiftInwards. For pure vars in
      * update definitions use RoundUp. For RVars in update
      * definitions use GuardWithIf. */
@@ -89,6 +101,22 @@ enum class PrefetchBoundStrategy {
     NonFaulting
 };
 
+/** How the data brought into the cache by a prefetch will be used. This
+ * selects between read and write prefetches, and whether the data should
+ * be kept close to the core or brought in without displacing other data
+ * (for data touched only once). Targets without the corresponding
+ * instructions fall back to a plain prefetch. */
+enum class PrefetchHint {
+    /** The data will be read, and may be read again soon. */
+    Read,
+    /** The data will be written, and may be accessed again soon. */
+    Write,
+    /** The data will be read once. */
+    ReadNonTemporal,
+    /** The data will be written once. */
+    WriteNonTemporal
+};
+
 /** A reference to a site in a Halide statement at the top of the
  * body of a particular for loop. Evaluating a region of a halide
  * function is done by generating a loop nest that spans its
@@ -171,7 +199,7 @@ struct Split {
     Expr factor;
     bool exact; // Is it required that the factor divides the extent
                 // of the old var. True for splits of RVars. Forces
-                // tail strategy to be GuardWithIf.
+                // tail strategy to be GuardWithIf or Predicate.
     TailStrategy tail;
 
     enum SplitType {SplitVar = 0, RenameVar, FuseVars, PurifyRVar};
@@ -232,6 +260,7 @@ struct PrefetchDirective {
     PrefetchBoundStrategy strategy;
     // If it's a prefetch load from an image parameter, this points to that.
     Parameter param;
+    PrefetchHint hint;
 };
 
 struct FuncScheduleContents;
@@ -267,6 +296,22 @@ public:
     bool memoized() const;
     // @}
 
+    /** This flag is set to true if the schedule is memoized, and the
+     * contents of the input buffers it depends on are assumed not to
+     * change between invocations for a given coordinate. */
+    // @{
+    bool &persistent();
+    bool persistent() const;
+    // @}
+
+    /** This flag is set to true if dense vector stores to this
+     * function's buffers should bypass the cache where the target
+     * supports it. See \ref Func::store_non_temporal */
+    // @{
+    bool &non_temporal_stores();
+    bool non_temporal_stores() const;
+    // @}
+
     /** The list and order of dimensions used to store this
      * function. The first dimension in the vector corresponds to the
      * innermost dimension for storage (i.e. which dimension is
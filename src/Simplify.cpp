@@ -4549,7 +4549,7 @@ private:
             // Collapse the prefetched region into lower dimension whenever is possible.
             // TODO(psuriana): Deal with negative strides and overlaps.
 
-            internal_assert(op->args.size() % 2 == 0); // Format: {base, offset, extent0, min0, ...}
+            internal_assert(op->args.size() % 2 == 1); // Format: {base, offset, extent0, stride0, ..., hint}
 
             vector<Expr> args(op->args);
             bool changed = false;
@@ -4564,10 +4564,10 @@ private:
             // based on the storage dimension in ascending order (i.e. innermost
             // first and outermost last), so, it is enough to check for the upper
             // triangular pairs to see if any contiguous addresses exist.
-            for (size_t i = 2; i < args.size(); i += 2) {
+            for (size_t i = 2; i < args.size() - 1; i += 2) {
                 Expr extent_0 = args[i];
                 Expr stride_0 = args[i + 1];
-                for (size_t j = i + 2; j < args.size(); j += 2) {
+                for (size_t j = i + 2; j < args.size() - 1; j += 2) {
                     Expr extent_1 = args[j];
                     Expr stride_1 = args[j + 1];
 
@@ -6698,8 +6698,8 @@ void simplify_test() {
     {
         // Check that contiguous prefetch call get collapsed
         Expr base = Variable::make(Handle(), "buf");
-        check(Call::make(Int(32), Call::prefetch, {base, x, 4, 1, 64, 4, min(x + y, 128), 256}, Call::Intrinsic),
-              Call::make(Int(32), Call::prefetch, {base, x, min(x + y, 128) * 256, 1}, Call::Intrinsic));
+        check(Call::make(Int(32), Call::prefetch, {base, x, 4, 1, 64, 4, min(x + y, 128), 256, 0}, Call::Intrinsic),
+              Call::make(Int(32), Call::prefetch, {base, x, min(x + y, 128) * 256, 1, 0}, Call::Intrinsic));
     }
 
     // Check min(x, y)*max(x, y) gets simplified into x*y
@@ -0,0 +1,74 @@
+#include "SpecializeBufferShapes.h"
+#include "IRVisitor.h"
+#include "IROperator.h"
+
+#include <map>
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::string;
+
+namespace {
+
+class FindBufferParams : public IRGraphVisitor {
+    using IRGraphVisitor::visit;
+
+    void visit_param(const Parameter &param) {
+        if (param.defined() && param.is_buffer()) {
+            params[param.name()] = param;
+        }
+    }
+
+    void visit(const Variable *op) {
+        visit_param(op->param);
+    }
+
+    void visit(const Call *op) {
+        IRGraphVisitor::visit(op);
+        visit_param(op->param);
+    }
+
+public:
+    map<string, Parameter> params;
+};
+
+Expr add_term(Expr condition, Expr term) {
+    return condition.defined() ? (condition && term) : term;
+}
+
+}  // namespace
+
+Stmt specialize_buffer_shapes(Stmt s) {
+    FindBufferParams finder;
+    s.accept(&finder);
+
+    Expr condition;
+    for (const auto &p : finder.params) {
+        const Parameter &param = p.second;
+        for (int i = 0; i < param.dimensions(); i++) {
+            string dim = std::to_string(i);
+            Expr extent = param.extent_specialization(i);
+            Expr stride = param.stride_specialization(i);
+            if (extent.defined()) {
+                Expr var = Variable::make(Int(32), param.name() + ".extent." + dim, param);
+                condition = add_term(condition, var == cast<int32_t>(extent));
+            }
+            if (stride.defined()) {
+                Expr var = Variable::make(Int(32), param.name() + ".stride." + dim, param);
+                condition = add_term(condition, var == cast<int32_t>(stride));
+            }
+        }
+    }
+
+    if (!condition.defined()) {
+        return s;
+    }
+
+    debug(2) << "Specializing pipeline on buffer shapes: " << condition << "\n";
+    return IfThenElse::make(condition, s, s);
+}
+
+}
+}
@@ -0,0 +1,25 @@
+#ifndef HALIDE_SPECIALIZE_BUFFER_SHAPES_H
+#define HALIDE_SPECIALIZE_BUFFER_SHAPES_H
+
+#include "IR.h"
+
+/** \file
+ * Defines a pass that specializes a pipeline on the expected shapes of
+ * its input and output buffers.
+ */
+
+namespace Halide {
+namespace Internal {
+
+/** If any buffer parameter referenced by the pipeline declares an
+ * expected extent or stride (see Dimension::specialize_extent),
+ * wrap the pipeline in a single check that all of them hold, with a
+ * copy of the whole pipeline on each side. Later simplification
+ * substitutes the expected values as constants into the then case;
+ * the else case remains the general path. */
+Stmt specialize_buffer_shapes(Stmt s);
+
+}
+}
+
+#endif
@@ -92,10 +92,12 @@ class SplitTuples : public IRMutator {
 
             auto it = indices->second.begin();
             internal_assert((*it) < (int)op->types.size());
-            stmt = Prefetch::make(op->name + "." + std::to_string(*it), {op->types[(*it)]}, op->bounds);
+            stmt = Prefetch::make(op->name + "." + std::to_string(*it), {op->types[(*it)]}, op->bounds,
+                                  Parameter(), op->hint);
             for (++it; it != indices->second.end(); ++it) {
                 internal_assert((*it) < (int)op->types.size());
-                stmt = Block::make(stmt, Prefetch::make(op->name + "." + std::to_string(*it), {op->types[(*it)]}, op->bounds));
+                stmt = Block::make(stmt, Prefetch::make(op->name + "." + std::to_string(*it), {op->types[(*it)]}, op->bounds,
+                                                        Parameter(), op->hint));
             }
         } else {
             IRMutator::visit(op);
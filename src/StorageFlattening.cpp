@@ -331,6 +331,7 @@ private:
                 args.push_back(prefetch_stride[i]);
             }
         }
+        args.push_back((int)op->hint);
 
         stmt = Evaluate::make(Call::make(op->types[0], Call::prefetch, args, Call::Intrinsic));
     }
@@ -498,6 +498,17 @@ class StorageFolding : public IRMutator {
         auto func_it = env.find(op->name);
         Function func = func_it != env.end() ? func_it->second : Function();
 
+        if (func_it != env.end() && func.schedule().memoized()) {
+            // Memoized Funcs are copied to and from the cache by
+            // coordinate, which doesn't work for folded storage.
+            if (body.same_as(op->body)) {
+                stmt = op;
+            } else {
+                stmt = Realize::make(op->name, op->types, op->bounds, op->condition, body);
+            }
+            return;
+        }
+
         // Don't attempt automatic storage folding if there is
         // more than one produce node for this func.
         bool explicit_only = count_producers(body, op->name) != 1;
@@ -266,6 +266,12 @@ const std::map<std::string, Target::Feature> feature_name_map = {
     {"trace_loads", Target::TraceLoads},
     {"trace_stores", Target::TraceStores},
     {"trace_realizations", Target::TraceRealizations},
+    {"fast_compile", Target::FastCompile},
+    {"check_cache", Target::CheckCache},
+    {"auto_prefetch", Target::AutoPrefetch},
+    {"narrow_arithmetic", Target::NarrowArithmetic},
+    {"memory_planning", Target::MemoryPlanning},
+    {"no_loop_carry", Target::NoLoopCarry},
 };
 
 bool lookup_feature(const std::string &tok, Target::Feature &result) {
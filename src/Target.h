@@ -85,6 +85,12 @@ struct Target {
         TraceLoads = halide_target_feature_trace_loads,
         TraceStores = halide_target_feature_trace_stores,
         TraceRealizations = halide_target_feature_trace_realizations,
+        FastCompile = halide_target_feature_fast_compile,
+        CheckCache = halide_target_feature_check_cache,
+        AutoPrefetch = halide_target_feature_auto_prefetch,
+        NarrowArithmetic = halide_target_feature_narrow_arithmetic,
+        MemoryPlanning = halide_target_feature_memory_planning,
+        NoLoopCarry = halide_target_feature_no_loop_carry,
         FeatureEnd = halide_target_feature_end
     };
     Target() : os(OSUnknown), arch(ArchUnknown), bits(0) {}
@@ -17,6 +17,7 @@
 namespace Halide {
 namespace Internal {
 
+using std::map;
 using std::string;
 using std::vector;
 using std::pair;
@@ -236,6 +237,8 @@ class PredicateLoadStore : public IRMutator {
     string var;
     Expr vector_predicate;
     bool in_hexagon;
+    // Was the loop split with TailStrategy::Predicate?
+    bool predicate_tail;
     const Target &target;
     int lanes;
     bool valid;
@@ -249,6 +252,19 @@ class PredicateLoadStore : public IRMutator {
                 << "We are inside a hexagon loop, but the target doesn't have hexagon's features\n";
             return true;
         } else if (target.arch == Target::X86) {
+            if (predicate_tail) {
+                // Use masked loads and stores wherever the hardware
+                // has them: AVX-512 mask registers, or AVX
+                // vmaskmov for 32- and 64-bit lanes.
+                bool avx512 = target.features_any_of({Target::AVX512, Target::AVX512_KNL,
+                                                      Target::AVX512_Skylake, Target::AVX512_Cannonlake});
+                bool avx512bw = target.features_any_of({Target::AVX512_Skylake, Target::AVX512_Cannonlake});
+                if (bit_size == 8 || bit_size == 16) {
+                    if (avx512bw) return true;
+                } else if (bit_size == 32 || bit_size == 64) {
+                    if (avx512 || target.features_any_of({Target::AVX, Target::AVX2})) return true;
+                }
+            }
             // Should only attempt to predicate store/load if the lane size is
             // no less than 4
             return (bit_size == 32) && (lanes >= 4);
@@ -338,8 +354,8 @@ class PredicateLoadStore : public IRMutator {
     }
 
 public:
-    PredicateLoadStore(string v, Expr vpred, bool in_hexagon, const Target &t) :
-            var(v), vector_predicate(vpred), in_hexagon(in_hexagon), target(t),
+    PredicateLoadStore(string v, Expr vpred, bool in_hexagon, bool predicate_tail, const Target &t) :
+            var(v), vector_predicate(vpred), in_hexagon(in_hexagon), predicate_tail(predicate_tail), target(t),
             lanes(vpred.type().lanes()), valid(true), vectorized(false) {
         internal_assert(lanes > 1);
     }
@@ -362,6 +378,8 @@ class VectorSubs : public IRMutator {
 
     bool in_hexagon; // Are we inside the hexagon loop?
 
+    bool predicate_tail; // Was the loop split with TailStrategy::Predicate?
+
     // A suffix to attach to widened variables.
     string widening_suffix;
 
@@ -691,12 +709,12 @@ class VectorSubs : public IRMutator {
             bool vectorize_predicate = !uses_gpu_vars(cond);
             Stmt predicated_stmt;
             if (vectorize_predicate) {
-                PredicateLoadStore p(var, cond, in_hexagon, target);
+                PredicateLoadStore p(var, cond, in_hexagon, predicate_tail, target);
                 predicated_stmt = p.mutate(then_case);
                 vectorize_predicate = p.is_vectorized();
             }
             if (vectorize_predicate && else_case.defined()) {
-                PredicateLoadStore p(var, !cond, in_hexagon, target);
+                PredicateLoadStore p(var, !cond, in_hexagon, predicate_tail, target);
                 predicated_stmt = Block::make(predicated_stmt, p.mutate(else_case));
                 vectorize_predicate = p.is_vectorized();
             }
@@ -907,19 +925,50 @@ class VectorSubs : public IRMutator {
     }
 
 public:
-    VectorSubs(string v, Expr r, bool in_hexagon, const Target &t) :
-            var(v), replacement(r), target(t), in_hexagon(in_hexagon) {
+    VectorSubs(string v, Expr r, bool in_hexagon, bool predicate_tail, const Target &t) :
+            var(v), replacement(r), target(t), in_hexagon(in_hexagon), predicate_tail(predicate_tail) {
         widening_suffix = ".x" + std::to_string(replacement.type().lanes());
     }
 };
 
 // Vectorize all loops marked as such in a Stmt
 class VectorizeLoops : public IRMutator {
+    const map<string, Function> &env;
     const Target &target;
     bool in_hexagon;
 
     using IRMutator::visit;
 
+    // Check if a loop is the inner loop of a split with
+    // TailStrategy::Predicate, or is nested within one by further
+    // splits of that inner loop.
+    bool has_predicated_tail(const string &loop_name) {
+        vector<string> v = split_string(loop_name, ".");
+        if (v.size() < 3 || v[1].empty() || v[1][0] != 's') {
+            return false;
+        }
+        auto it = env.find(v[0]);
+        if (it == env.end()) {
+            return false;
+        }
+        const Function &f = it->second;
+        int stage = atoi(v[1].c_str() + 1);
+        if (stage < 0 || stage > (int)f.updates().size()) {
+            return false;
+        }
+        const Definition &def = (stage == 0) ? f.definition() : f.update(stage - 1);
+        string prefix = v[0] + "." + v[1] + ".";
+        for (const Split &s : def.schedule().splits()) {
+            if (s.is_split() && s.tail == TailStrategy::Predicate) {
+                string inner = prefix + s.inner;
+                if (loop_name == inner || starts_with(loop_name, inner + ".")) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
     void visit(const For *for_loop) {
         bool old_in_hexagon = in_hexagon;
         if (for_loop->device_api == DeviceAPI::Hexagon) {
@@ -938,7 +987,8 @@ class VectorizeLoops : public IRMutator {
             // Replace the var with a ramp within the body
             Expr for_var = Variable::make(for_loop->min.type(), for_loop->name);
             Expr replacement = Ramp::make(for_loop->min, cast(for_loop->min.type(), Expr(1)), extent->value);
-            stmt = VectorSubs(for_loop->name, replacement, in_hexagon, target).mutate(for_loop->body);
+            bool predicate_tail = has_predicated_tail(for_loop->name);
+            stmt = VectorSubs(for_loop->name, replacement, in_hexagon, predicate_tail, target).mutate(for_loop->body);
         } else {
             IRMutator::visit(for_loop);
         }
@@ -949,13 +999,13 @@ class VectorizeLoops : public IRMutator {
     }
 
 public:
-    VectorizeLoops(const Target &t) : target(t), in_hexagon(false) {}
+    VectorizeLoops(const map<string, Function> &env, const Target &t) : env(env), target(t), in_hexagon(false) {}
 };
 
 } // Anonymous namespace
 
-Stmt vectorize_loops(Stmt s, const Target &t) {
-    return VectorizeLoops(t).mutate(s);
+Stmt vectorize_loops(Stmt s, const map<string, Function> &env, const Target &t) {
+    return VectorizeLoops(env, t).mutate(s);
 }
 
 }
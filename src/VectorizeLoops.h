@@ -5,6 +5,8 @@
  * Defines the lowering pass that vectorizes loops marked as such
  */
 
+#include <map>
+
 #include "IR.h"
 #include "Target.h"
 
@@ -13,9 +15,10 @@ namespace Internal {
 
 /** Take a statement with for loops marked for vectorization, and turn
  * them into single statements that operate on vectors. The loops in
- * question must have constant extent.
+ * question must have constant extent. The environment is used to find
+ * loops split with TailStrategy::Predicate.
  */
-Stmt vectorize_loops(Stmt s, const Target &t);
+Stmt vectorize_loops(Stmt s, const std::map<std::string, Function> &env, const Target &t);
 
 }
 }
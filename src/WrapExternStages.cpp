@@ -244,5 +244,160 @@ void add_legacy_wrapper(Module module, const LoweredFunc &fn) {
     module.append(wrapper);
 }
 
+void add_batch_wrapper(Module module, const LoweredFunc &fn, const LoweredFunc &unchecked_fn) {
+    internal_assert(unchecked_fn.args.size() == fn.args.size())
+        << unchecked_fn.name << " does not take the same arguments as " << fn.name << "\n";
+
+    // The batch dimension is the extent and min of the extra outermost
+    // dimension of the first buffer argument. Every other buffer must
+    // agree with it.
+    vector<LoweredArgument> args;
+    vector<Stmt> prologue, epilogue;
+    vector<Expr> call_args;
+    vector<pair<string, Expr>> aliases, slices;
+    Expr batch_min, batch_extent, any_bounds_query;
+    Expr loop_var = Variable::make(Int(32), fn.name + ".batch");
+    for (LoweredArgument arg : fn.args) {
+        if (arg.kind == Argument::InputScalar) {
+            args.push_back(arg);
+            call_args.push_back(Variable::make(arg.type, arg.name));
+            continue;
+        }
+
+        int d = arg.dimensions;
+        arg.dimensions = d + 1;
+        args.push_back(arg);
+
+        Expr buffer_var = Variable::make(type_of<struct halide_buffer_t *>(), arg.name + ".buffer");
+        Expr min = Call::make(Int(32), Call::buffer_get_min, {buffer_var, d}, Call::Extern);
+        Expr extent = Call::make(Int(32), Call::buffer_get_extent, {buffer_var, d}, Call::Extern);
+        Expr bounds_query = Call::make(Bool(), Call::buffer_is_bounds_query, {buffer_var}, Call::Extern);
+
+        if (!batch_min.defined()) {
+            batch_min = min;
+            batch_extent = extent;
+            any_bounds_query = bounds_query;
+        } else {
+            Expr error = Call::make(Int(32), "halide_error_bad_batch_dimension",
+                                    {fn.name, arg.name, min, extent, batch_min, batch_extent},
+                                    Call::Extern);
+            prologue.push_back(AssertStmt::make(min == batch_min && extent == batch_extent, error));
+            any_bounds_query = any_bounds_query || bounds_query;
+        }
+
+        // The slices only refer to host memory, so bring any
+        // device-dirty data back first. Outputs written through the
+        // slices leave the parent host-dirty.
+        Expr copy_call = Call::make(Int(32), "halide_copy_to_host", {buffer_var}, Call::Extern);
+        prologue.push_back(make_checked_call(copy_call));
+        if (arg.is_output()) {
+            Expr set_dirty = Call::make(Int(32), Call::buffer_set_host_dirty,
+                                        {buffer_var, const_true()}, Call::Extern);
+            epilogue.push_back(Evaluate::make(set_dirty));
+        }
+
+        // Make a host-only alias of the parent, so that cropping it
+        // doesn't make device crops we would have to release.
+        BufferBuilder alias;
+        alias.host = Call::make(Handle(), Call::buffer_get_host, {buffer_var}, Call::Extern);
+        alias.type = arg.type;
+        alias.dimensions = d + 1;
+        vector<Expr> crop_mins, crop_extents;
+        for (int i = 0; i <= d; i++) {
+            Expr min_i = Call::make(Int(32), Call::buffer_get_min, {buffer_var, i}, Call::Extern);
+            Expr extent_i = Call::make(Int(32), Call::buffer_get_extent, {buffer_var, i}, Call::Extern);
+            alias.mins.push_back(min_i);
+            alias.extents.push_back(extent_i);
+            alias.strides.push_back(Call::make(Int(32), Call::buffer_get_stride, {buffer_var, i}, Call::Extern));
+            if (i < d) {
+                crop_mins.push_back(min_i);
+                crop_extents.push_back(extent_i);
+            }
+        }
+        string alias_name = arg.name + ".batch_host";
+        Expr alias_var = Variable::make(type_of<struct halide_buffer_t *>(), alias_name);
+        aliases.emplace_back(alias_name, alias.build());
+
+        // Crop the batch dimension of the alias to a single item to
+        // get the host pointer of the slice, then describe the slice
+        // with the remaining dimensions of the parent.
+        crop_mins.push_back(loop_var);
+        crop_extents.push_back(1);
+        vector<Expr> crop_args(5);
+        crop_args[0] = Call::make(type_of<struct halide_buffer_t *>(), Call::alloca,
+                                  {Call::make(Int(32), Call::size_of_halide_buffer_t, {}, Call::Intrinsic)},
+                                  Call::Intrinsic);
+        crop_args[1] = Call::make(type_of<struct halide_dimension_t *>(), Call::alloca,
+                                  {(int)sizeof(halide_dimension_t) * (d + 1)}, Call::Intrinsic);
+        crop_args[2] = alias_var;
+        crop_args[3] = Call::make(Handle(), Call::make_struct, crop_mins, Call::Intrinsic);
+        crop_args[4] = Call::make(Handle(), Call::make_struct, crop_extents, Call::Intrinsic);
+        Expr crop = Call::make(type_of<struct halide_buffer_t *>(), Call::buffer_crop, crop_args, Call::Extern);
+
+        string crop_name = arg.name + ".batch_crop";
+        Expr crop_var = Variable::make(type_of<struct halide_buffer_t *>(), crop_name);
+        slices.emplace_back(crop_name, crop);
+
+        BufferBuilder builder;
+        builder.host = Call::make(Handle(), Call::buffer_get_host, {crop_var}, Call::Extern);
+        builder.type = arg.type;
+        builder.dimensions = d;
+        for (int i = 0; i < d; i++) {
+            builder.mins.push_back(crop_mins[i]);
+            builder.extents.push_back(crop_extents[i]);
+            builder.strides.push_back(alias.strides[i]);
+        }
+        string slice_name = arg.name + ".batch_slice";
+        slices.emplace_back(slice_name, builder.build());
+        call_args.push_back(Variable::make(type_of<struct halide_buffer_t *>(), slice_name));
+    }
+    internal_assert(batch_min.defined()) << "Can't add a batch wrapper to " << fn.name << ", which has no buffer arguments\n";
+
+    Call::CallType call_type = Call::Extern;
+    if (fn.name_mangling == NameMangling::CPlusPlus ||
+        (fn.name_mangling == NameMangling::Default &&
+         module.target().has_feature(Target::CPlusPlusMangling))) {
+        call_type = Call::ExternCPlusPlus;
+    }
+    auto call_on_slices = [&](const string &name) {
+        Stmt s = make_checked_call(Call::make(Int(32), name, call_args, call_type));
+        for (size_t i = slices.size(); i > 0; i--) {
+            s = LetStmt::make(slices[i-1].first, slices[i-1].second, s);
+        }
+        return s;
+    };
+
+    // Every item has the same shape, so the first item goes through
+    // the fully checked entry point, which validates the arguments
+    // for all of them. The rest are then run in parallel through the
+    // variant that skips those checks.
+    string batch_min_name = fn.name + ".batch.min";
+    string batch_extent_name = fn.name + ".batch.extent";
+    Expr batch_min_var = Variable::make(Int(32), batch_min_name);
+    Expr batch_extent_var = Variable::make(Int(32), batch_extent_name);
+    Stmt first = LetStmt::make(fn.name + ".batch", batch_min_var, call_on_slices(fn.name));
+    Stmt rest = For::make(fn.name + ".batch", batch_min_var + 1, batch_extent_var - 1,
+                          ForType::Parallel, DeviceAPI::None, call_on_slices(unchecked_fn.name));
+    Stmt body = IfThenElse::make(batch_extent_var > 0, Block::make(first, rest));
+    body = Block::make(body, Block::make(epilogue));
+    while (!aliases.empty()) {
+        auto p = aliases.back();
+        body = LetStmt::make(p.first, p.second, body);
+        aliases.pop_back();
+    }
+    body = Block::make(Block::make(prologue), body);
+
+    // Bounds queries would have to be answered per item, so they are
+    // rejected outright.
+    Expr bounds_query_error = Call::make(Int(32), "halide_error_batch_bounds_query", {fn.name}, Call::Extern);
+    body = Block::make(AssertStmt::make(!any_bounds_query, bounds_query_error), body);
+    body = LetStmt::make(batch_extent_name, batch_extent, body);
+    body = LetStmt::make(batch_min_name, batch_min, body);
+
+    debug(2) << "Added batch wrapper for " << fn.name << ":\n" << body << "\n\n";
+    LoweredFunc wrapper(fn.name + "_batch", args, body, LoweredFunc::External, fn.name_mangling);
+    module.append(wrapper);
+}
+
 }
 }
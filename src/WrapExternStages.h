@@ -20,6 +20,15 @@ void wrap_legacy_extern_stages(Module m);
  * upgrades them. */
 void add_legacy_wrapper(Module m, const LoweredFunc &fn);
 
+/** Add a wrapper named fn.name + "_batch" for a LoweredFunc that
+ * accepts buffers with one extra outermost dimension. The wrapper
+ * checks once that all buffers agree on the min and extent of that
+ * dimension, and calls fn on the first slice of it, which checks the
+ * rest of the arguments. It then calls unchecked_fn, which must take
+ * the same arguments but skip those checks, on the remaining slices
+ * in parallel. */
+void add_batch_wrapper(Module m, const LoweredFunc &fn, const LoweredFunc &unchecked_fn);
+
 }
 }
 
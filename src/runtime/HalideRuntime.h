@@ -225,6 +225,16 @@ extern halide_malloc_t halide_set_custom_malloc(halide_malloc_t user_malloc);
 extern halide_free_t halide_set_custom_free(halide_free_t user_free);
 //@}
 
+/** Set the size (in bytes) above which halide_default_malloc services
+ * allocations directly with mmap, aligned to the huge page size and
+ * marked as eligible for transparent huge pages. This greatly reduces
+ * TLB misses for very large intermediates. A threshold of zero (the
+ * default) disables this. The initial value can also be set with the
+ * environment variable HL_HUGE_PAGE_THRESHOLD, which is the only way
+ * to set it for JIT-compiled code. Returns the previous
+ * threshold. Currently only has an effect on Linux. */
+extern size_t halide_set_huge_page_threshold(size_t threshold);
+
 /** Halide calls these functions to interact with the underlying
  * system runtime functions. To replace in AOT code on platforms that
  * support weak linking, define these functions yourself, or use
@@ -696,6 +706,18 @@ extern int halide_memoization_cache_store(void *user_context, const uint8_t *cac
                                           int32_t tuple_count,
                                           struct halide_buffer_t **tuple_buffers);
 
+/** Copy the region described by computed_bounds from each of the
+ * src buffers to the corresponding dst buffer. Used to memoize
+ * outputs, and Funcs stored outside their compute level, whose
+ * storage can't come from the cache: on a hit, the cached buffers
+ * are copied into the Func's storage, and on a miss, the newly
+ * computed region is copied into the buffers to be stored.
+ * Returns zero on success, or an error code.
+ */
+extern int halide_memoization_cache_copy(void *user_context, const struct halide_buffer_t *computed_bounds,
+                                         int32_t tuple_count, struct halide_buffer_t **src,
+                                         struct halide_buffer_t **dst);
+
 /** If halide_memoization_cache_lookup succeeds,
  * halide_memoization_cache_release must be called to signal the
  * storage is no longer being used by the caller. It will be passed
@@ -718,6 +740,20 @@ extern void halide_memoization_cache_release(void *user_context, void *host);
  */
 extern void halide_memoization_cache_cleanup();
 
+/** Used by pipelines compiled with the check_cache target feature to
+ * skip their buffer checks when called with the same shapes as the
+ * last call that passed them. The signature is an array of size
+ * int32s describing the shapes; *cache is pipeline-owned state that
+ * starts out null. halide_check_cache_lookup returns 1 if the
+ * signature matches the one last stored in *cache, and 0
+ * otherwise. halide_check_cache_store replaces it, and returns 0. */
+// @{
+extern int halide_check_cache_lookup(void *user_context, void **cache,
+                                     const int32_t *signature, int32_t size);
+extern int halide_check_cache_store(void *user_context, void **cache,
+                                    const int32_t *signature, int32_t size);
+// @}
+
 /** Create a unique file with a name of the form prefixXXXXXsuffix in an arbitrary
  * (but writable) directory; this is typically $TMP or /tmp, but the specific
  * location is not guaranteed. (Note that the exact form of the file name
@@ -931,6 +967,16 @@ enum halide_error_code_t {
      * existed on a different device interface. Free the old one
      * first. */
     halide_error_code_incompatible_device_interface = -42,
+
+    /** The buffers passed to a batched entry point did not all have
+     * the same min and extent in their outermost (batch)
+     * dimension. */
+    halide_error_code_bad_batch_dimension = -43,
+
+    /** A batched entry point was called in bounds query
+     * mode. Batched entry points do not support bounds queries; call
+     * the unbatched entry point instead. */
+    halide_error_code_batch_bounds_query = -44,
 };
 
 /** Halide calls the functions below on various error conditions. The
@@ -1007,6 +1053,9 @@ extern int halide_error_no_device_interface(void *user_context);
 extern int halide_error_device_interface_no_device(void *user_context);
 extern int halide_error_host_and_device_dirty(void *user_context);
 extern int halide_error_buffer_is_null(void *user_context, const char *routine);
+extern int halide_error_bad_batch_dimension(void *user_context, const char *func_name, const char *buffer_name,
+                                            int min, int extent, int batch_min, int batch_extent);
+extern int halide_error_batch_bounds_query(void *user_context, const char *func_name);
 
 // @}
 
@@ -1076,7 +1125,13 @@ typedef enum halide_target_feature_t {
     halide_target_feature_cuda_capability61 = 46,  ///< Enable CUDA compute capability 6.1 (Pascal)
     halide_target_feature_hvx_v65 = 47, ///< Enable Hexagon v65 architecture.
     halide_target_feature_hvx_v66 = 48, ///< Enable Hexagon v66 architecture.
-    halide_target_feature_end = 49, ///< A sentinel. Every target is considered to have this feature, and setting this feature does nothing.
+    halide_target_feature_fast_compile = 49, ///< Minimize compile time at the expense of the speed of the generated code.
+    halide_target_feature_check_cache = 50, ///< Skip buffer checks on calls with the same shapes as the last call that passed them.
+    halide_target_feature_auto_prefetch = 51, ///< Prefetch the next tile or row of inputs in loops without an explicit prefetch schedule.
+    halide_target_feature_narrow_arithmetic = 52, ///< Narrow vector integer arithmetic to the smallest type that bounds analysis proves can't overflow.
+    halide_target_feature_memory_planning = 53, ///< Pack heap allocations with disjoint lifetimes into shared slabs.
+    halide_target_feature_no_loop_carry = 54, ///< Don't keep values loaded on one loop iteration in registers for the next.
+    halide_target_feature_end = 55, ///< A sentinel. Every target is considered to have this feature, and setting this feature does nothing.
 } halide_target_feature_t;
 
 /** This function is called internally by Halide in some situations to determine
@@ -1442,6 +1497,10 @@ struct halide_profiler_func_stats {
 
     /** The total number of memory allocation of this Func. */
     int num_allocs;
+
+    /** The number of page faults incurred while computing this Func
+     * (zero on platforms which don't report page faults). */
+    uint64_t page_faults;
 };
 
 /** Per-pipeline state tracked by the sampling profiler. These exist
@@ -1487,6 +1546,9 @@ struct halide_profiler_pipeline_stats {
 
     /** The total number of memory allocation of funcs in this pipeline. */
     int num_allocs;
+
+    /** The number of page faults incurred inside this pipeline. */
+    uint64_t page_faults;
 };
 
 /** The global state of the profiler. */
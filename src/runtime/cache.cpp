@@ -87,7 +87,7 @@ struct CacheEntry {
     uint8_t *metadata_storage;
     size_t key_size;
     uint8_t *key;
-    uint32_t hash;
+    uint64_t hash;
     uint32_t in_use_count; // 0 if none returned from halide_cache_lookup
     uint32_t tuple_count;
     // The shape of the computed data. There may be more data allocated than this.
@@ -97,7 +97,7 @@ struct CacheEntry {
     halide_buffer_t *buf;
 
     bool init(const uint8_t *cache_key, size_t cache_key_size,
-              uint32_t key_hash,
+              uint64_t key_hash,
               const halide_buffer_t *computed_bounds_buf,
               int32_t tuples, halide_buffer_t **tuple_buffers);
     void destroy();
@@ -107,7 +107,7 @@ struct CacheEntry {
 
 struct CacheBlockHeader {
     CacheEntry *entry;
-    uint32_t hash;
+    uint64_t hash;
 };
 
 WEAK CacheBlockHeader *get_pointer_to_header(uint8_t * host) {
@@ -115,7 +115,7 @@ WEAK CacheBlockHeader *get_pointer_to_header(uint8_t * host) {
 }
 
 WEAK bool CacheEntry::init(const uint8_t *cache_key, size_t cache_key_size,
-                           uint32_t key_hash, const halide_buffer_t *computed_bounds_buf,
+                           uint64_t key_hash, const halide_buffer_t *computed_bounds_buf,
                            int32_t tuples, halide_buffer_t **tuple_buffers) {
     next = NULL;
     more_recent = NULL;
@@ -181,10 +181,58 @@ WEAK void CacheEntry::destroy() {
     halide_free(NULL, metadata_storage);
 }
 
-WEAK uint32_t djb_hash(const uint8_t *key, size_t key_size)  {
-    uint32_t h = 5381;
-    for (size_t i = 0; i < key_size; i++) {
-      h = (h << 5) + h + key[i];
+WEAK uint64_t hash_mix(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+// Keys start with a 16-byte function identity, followed by the
+// parameter values, so they are mostly made of whole words. Hash them
+// a word at a time in four independent lanes so the multiplies can
+// overlap (or be vectorized), then fold the lanes together.
+WEAK uint64_t hash_cache_key(const uint8_t *key, size_t key_size) {
+    const uint64_t k = 0x9e3779b97f4a7c15ULL;
+    uint64_t lanes[4] = {k, k * 3, k * 5, k * 7};
+    size_t i = 0;
+    for (; i + 32 <= key_size; i += 32) {
+        for (int j = 0; j < 4; j++) {
+            uint64_t word;
+            memcpy(&word, key + i + j * 8, 8);
+            lanes[j] = (lanes[j] ^ word) * 0xff51afd7ed558ccdULL;
+            lanes[j] ^= lanes[j] >> 32;
+        }
+    }
+    uint64_t h = key_size * k;
+    for (int j = 0; j < 4; j++) {
+        h = hash_mix(h ^ lanes[j]);
+    }
+    for (; i + 8 <= key_size; i += 8) {
+        uint64_t word;
+        memcpy(&word, key + i, 8);
+        h = hash_mix(h ^ word);
+    }
+    if (i < key_size) {
+        uint64_t word = 0;
+        memcpy(&word, key + i, key_size - i);
+        h = hash_mix(h ^ word);
+    }
+    return h;
+}
+
+// Many produce nodes of one Func share a key and differ only in the
+// region they computed, so mix the computed bounds into the hash as
+// well, or all the tiles of a Func would land in one bucket.
+WEAK uint64_t hash_cache_entry(const uint8_t *key, size_t key_size,
+                               const halide_buffer_t *computed_bounds) {
+    uint64_t h = hash_cache_key(key, key_size);
+    for (int32_t i = 0; i < computed_bounds->dimensions; i++) {
+        uint64_t word = (((uint64_t)(uint32_t)computed_bounds->dim[i].min << 32) |
+                         (uint32_t)computed_bounds->dim[i].extent);
+        h = hash_mix(h ^ word);
     }
     return h;
 }
@@ -263,7 +311,7 @@ WEAK void prune_cache() {
         CacheEntry *more_recent = prune_candidate->more_recent;
 
         if (prune_candidate->in_use_count == 0) {
-            uint32_t h = prune_candidate->hash;
+            uint64_t h = prune_candidate->hash;
             uint32_t index = h % kHashTableSize;
 
             // Remove from hash table
@@ -328,7 +376,7 @@ WEAK void halide_memoization_cache_set_size(int64_t size) {
 
 WEAK int halide_memoization_cache_lookup(void *user_context, const uint8_t *cache_key, int32_t size,
                                          halide_buffer_t *computed_bounds, int32_t tuple_count, halide_buffer_t **tuple_buffers) {
-    uint32_t h = djb_hash(cache_key, size);
+    uint64_t h = hash_cache_entry(cache_key, size, computed_bounds);
     uint32_t index = h % kHashTableSize;
 
     ScopedMutexLock lock(&memoization_lock);
@@ -422,7 +470,12 @@ WEAK int halide_memoization_cache_store(void *user_context, const uint8_t *cache
                                         int32_t tuple_count, halide_buffer_t **tuple_buffers) {
     debug(user_context) << "halide_memoization_cache_store\n";
 
-    uint32_t h = get_pointer_to_header(tuple_buffers[0]->host)->hash;
+    // The lookup that allocated these buffers already hashed the key
+    // and computed bounds.
+    uint64_t h = get_pointer_to_header(tuple_buffers[0]->host)->hash;
+#if CACHE_DEBUGGING
+    halide_assert(user_context, h == hash_cache_entry(cache_key, size, computed_bounds));
+#endif
 
     uint32_t index = h % kHashTableSize;
 
@@ -528,6 +581,36 @@ WEAK int halide_memoization_cache_store(void *user_context, const uint8_t *cache
     return 0;
 }
 
+WEAK int halide_memoization_cache_copy(void *user_context, const halide_buffer_t *computed_bounds,
+                                       int32_t tuple_count, halide_buffer_t **src, halide_buffer_t **dst) {
+    const int dimensions = computed_bounds->dimensions;
+    if (dimensions > MAX_COPY_DIMS) {
+        error(user_context) << "Memoized buffers may have at most " << MAX_COPY_DIMS << " dimensions\n";
+        return halide_error_code_internal_error;
+    }
+
+    for (int32_t i = 0; i < tuple_count; i++) {
+        // Crop dst to the computed region. It's contained in src,
+        // because the cached buffers cover exactly the computed
+        // region, and the storage of the Func covers at least that.
+        halide_dimension_t shape[MAX_COPY_DIMS];
+        halide_buffer_t crop = *dst[i];
+        crop.dim = shape;
+        int64_t offset = 0;
+        for (int d = 0; d < dimensions; d++) {
+            shape[d] = dst[i]->dim[d];
+            shape[d].min = computed_bounds->dim[d].min;
+            shape[d].extent = computed_bounds->dim[d].extent;
+            offset += (int64_t)(shape[d].min - dst[i]->dim[d].min) * shape[d].stride;
+        }
+        crop.host = dst[i]->host + offset * dst[i]->type.bytes();
+
+        device_copy c = make_buffer_copy(src[i], true, &crop, true);
+        copy_memory(c, user_context);
+    }
+    return 0;
+}
+
 WEAK void halide_memoization_cache_release(void *user_context, void *host) {
     CacheBlockHeader *header = get_pointer_to_header((uint8_t *)host);
     debug(user_context) << "halide_memoization_cache_release\n";
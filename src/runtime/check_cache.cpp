@@ -0,0 +1,68 @@
+#include "HalideRuntime.h"
+#include "scoped_mutex_lock.h"
+
+// Pipelines compiled with the check_cache target feature remember the
+// shape signature of the last call that passed their buffer checks,
+// and skip those checks while the signature doesn't change. The
+// signature is a list of int32s built by the pipeline; the runtime
+// just stores and compares it.
+
+namespace Halide { namespace Runtime { namespace Internal {
+
+struct CheckCacheEntry {
+    int32_t size;
+    int32_t signature[1];
+};
+
+// Lookups and stores only touch a few dozen ints, so a single lock
+// shared by all pipelines is enough.
+WEAK halide_mutex check_cache_lock;
+
+}}}  // namespace Halide::Runtime::Internal
+
+using namespace Halide::Runtime::Internal;
+
+extern "C" {
+
+WEAK int halide_check_cache_lookup(void *user_context, void **cache,
+                                   const int32_t *signature, int32_t size) {
+    ScopedMutexLock lock(&check_cache_lock);
+    const CheckCacheEntry *entry = (const CheckCacheEntry *)(*cache);
+    if (entry == NULL || entry->size != size) {
+        return 0;
+    }
+    for (int32_t i = 0; i < size; i++) {
+        if (entry->signature[i] != signature[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+WEAK int halide_check_cache_store(void *user_context, void **cache,
+                                  const int32_t *signature, int32_t size) {
+    ScopedMutexLock lock(&check_cache_lock);
+    CheckCacheEntry *entry = (CheckCacheEntry *)(*cache);
+    if (entry == NULL || entry->size != size) {
+        // The entry outlives this call, so it isn't allocated with the
+        // user_context. It is never freed; there is one per pipeline.
+        CheckCacheEntry *new_entry =
+            (CheckCacheEntry *)halide_malloc(NULL, sizeof(CheckCacheEntry) + size * sizeof(int32_t));
+        if (new_entry == NULL) {
+            // Not caching is always safe.
+            return 0;
+        }
+        if (entry != NULL) {
+            halide_free(NULL, entry);
+        }
+        new_entry->size = size;
+        entry = new_entry;
+        *cache = entry;
+    }
+    for (int32_t i = 0; i < size; i++) {
+        entry->signature[i] = signature[i];
+    }
+    return 0;
+}
+
+}  // extern "C"
@@ -44,6 +44,55 @@ struct device_copy {
 };
 
 
+// Copy a single element of the given size. Most host copies that
+// can't be coalesced are of individual scalars, so avoid paying for a
+// variable-sized memcpy call in the common cases.
+inline __attribute__((always_inline)) void copy_element(void *to, const void *from, uint64_t size) {
+    // Constant-size memcpy calls compile to a single (possibly
+    // unaligned) load and store.
+    switch (size) {
+    case 1:
+        memcpy(to, from, 1);
+        break;
+    case 2:
+        memcpy(to, from, 2);
+        break;
+    case 4:
+        memcpy(to, from, 4);
+        break;
+    case 8:
+        memcpy(to, from, 8);
+        break;
+    default:
+        memcpy(to, from, size);
+    }
+}
+
+// Copy the innermost two dimensions of a host copy in square
+// tiles. This is used when the two innermost dimensions have swapped
+// strides in the source (i.e. a transpose), so that neither the reads
+// nor the writes walk across memory with a large stride for more than
+// a few elements at a time.
+WEAK void copy_memory_transposed(const device_copy &copy, int64_t src_off, int64_t dst_off) {
+    const uint64_t tile = 16;
+    const uint64_t chunk_size = copy.chunk_size;
+    for (uint64_t y0 = 0; y0 < copy.extent[1]; y0 += tile) {
+        uint64_t y1 = y0 + tile < copy.extent[1] ? y0 + tile : copy.extent[1];
+        for (uint64_t x0 = 0; x0 < copy.extent[0]; x0 += tile) {
+            uint64_t x1 = x0 + tile < copy.extent[0] ? x0 + tile : copy.extent[0];
+            for (uint64_t y = y0; y < y1; y++) {
+                const uint8_t *from = (const uint8_t *)(copy.src + src_off + y * copy.src_stride_bytes[1]);
+                uint8_t *to = (uint8_t *)(copy.dst + dst_off + y * copy.dst_stride_bytes[1]);
+                for (uint64_t x = x0; x < x1; x++) {
+                    copy_element(to + x * copy.dst_stride_bytes[0],
+                                 from + x * copy.src_stride_bytes[0],
+                                 chunk_size);
+                }
+            }
+        }
+    }
+}
+
 WEAK void copy_memory_helper(const device_copy &copy, int d, int64_t src_off, int64_t dst_off) {
     // Skip size-1 dimensions
     while (d >= 0 && copy.extent[d] == 1) d--;
@@ -52,6 +101,21 @@ WEAK void copy_memory_helper(const device_copy &copy, int d, int64_t src_off, in
         const void *from = (void *)(copy.src + src_off);
         void *to = (void *)(copy.dst + dst_off);
         memcpy(to, from, copy.chunk_size);
+    } else if (d == 0) {
+        // The innermost loop. Copy the chunks directly rather than
+        // recursing once per chunk.
+        for (uint64_t i = 0; i < copy.extent[0]; i++) {
+            copy_element((void *)(copy.dst + dst_off), (const void *)(copy.src + src_off), copy.chunk_size);
+            src_off += copy.src_stride_bytes[0];
+            dst_off += copy.dst_stride_bytes[0];
+        }
+    } else if (d == 1 &&
+               copy.chunk_size <= 8 &&
+               copy.extent[0] > 1 &&
+               copy.src_stride_bytes[1] < copy.src_stride_bytes[0]) {
+        // The dst is dense in the innermost dimension, but the src is
+        // dense in the next one out. Copy in tiles.
+        copy_memory_transposed(copy, src_off, dst_off);
     } else {
         for (uint64_t i = 0; i < copy.extent[d]; i++) {
             copy_memory_helper(copy, d - 1, src_off, dst_off);
@@ -70,6 +134,19 @@ WEAK void copy_memory(const device_copy &copy, void *user_context) {
     }
 }
 
+// Remove a dimension from a copy task, shifting the outer dimensions
+// inwards.
+WEAK void erase_copy_dim(device_copy &c, int d) {
+    for (int j = d + 1; j < MAX_COPY_DIMS; j++) {
+        c.extent[j-1] = c.extent[j];
+        c.src_stride_bytes[j-1] = c.src_stride_bytes[j];
+        c.dst_stride_bytes[j-1] = c.dst_stride_bytes[j];
+    }
+    c.extent[MAX_COPY_DIMS-1] = 1;
+    c.src_stride_bytes[MAX_COPY_DIMS-1] = 0;
+    c.dst_stride_bytes[MAX_COPY_DIMS-1] = 0;
+}
+
 // Fills the entire dst buffer, which must be contained within src
 WEAK device_copy make_buffer_copy(const halide_buffer_t *src, bool src_host,
                                   const halide_buffer_t *dst, bool dst_host) {
@@ -134,26 +211,42 @@ WEAK device_copy make_buffer_copy(const halide_buffer_t *src, bool src_host,
         c.src_stride_bytes[insert] = src_stride_bytes;
     };
 
+    // Drop any size-1 dimensions. They do no work, and they would
+    // otherwise get in the way of folding the dimensions around them.
+    for (int i = MAX_COPY_DIMS - 1; i >= 0; i--) {
+        if (c.extent[i] == 1) {
+            erase_copy_dim(c, i);
+        }
+    }
+
     // Attempt to fold contiguous dimensions into the chunk
     // size. Since the dimensions are sorted by stride, and the
     // strides must be greater than or equal to the chunk size, this
     // means we can just delete the innermost dimension as long as its
     // stride in both src and dst is equal to the chunk size.
-    while (c.chunk_size == c.src_stride_bytes[0] &&
+    while (c.extent[0] != 1 &&
+           c.chunk_size == c.src_stride_bytes[0] &&
            c.chunk_size == c.dst_stride_bytes[0]) {
         // Fold the innermost dimension's extent into the chunk_size.
         c.chunk_size *= c.extent[0];
 
         // Erase the innermost dimension from the list of dimensions to
         // iterate over.
-        for (int j = 1; j < MAX_COPY_DIMS; j++) {
-            c.extent[j-1] = c.extent[j];
-            c.src_stride_bytes[j-1] = c.src_stride_bytes[j];
-            c.dst_stride_bytes[j-1] = c.dst_stride_bytes[j];
+        erase_copy_dim(c, 0);
+    }
+
+    // Collapse any remaining pairs of adjacent dimensions that are
+    // contiguous with respect to each other in both src and dst
+    // (e.g. the rows of a cropped buffer being copied into a buffer
+    // with the same row stride). This reduces the depth of the loop
+    // nest, and makes the innermost loop as long as possible.
+    for (int i = MAX_COPY_DIMS - 2; i >= 0; i--) {
+        if (c.extent[i] != 1 && c.extent[i+1] != 1 &&
+            c.src_stride_bytes[i+1] == c.src_stride_bytes[i] * c.extent[i] &&
+            c.dst_stride_bytes[i+1] == c.dst_stride_bytes[i] * c.extent[i]) {
+            c.extent[i] *= c.extent[i+1];
+            erase_copy_dim(c, i+1);
         }
-        c.extent[MAX_COPY_DIMS-1] = 1;
-        c.src_stride_bytes[MAX_COPY_DIMS-1] = 0;
-        c.dst_stride_bytes[MAX_COPY_DIMS-1] = 0;
     }
     return c;
 }
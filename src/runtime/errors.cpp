@@ -277,4 +277,20 @@ WEAK int halide_error_buffer_is_null(void *user_context, const char *routine) {
     return halide_error_code_buffer_is_null;
 }
 
+WEAK int halide_error_bad_batch_dimension(void *user_context, const char *func_name, const char *buffer_name,
+                                          int min, int extent, int batch_min, int batch_extent) {
+    error(user_context) << "The batch dimension of buffer " << buffer_name
+                        << " passed to " << func_name << " is ["
+                        << min << ", " << (min + extent - 1)
+                        << "], but the batch dimension of the first buffer is ["
+                        << batch_min << ", " << (batch_min + batch_extent - 1) << "]\n";
+    return halide_error_code_bad_batch_dimension;
+}
+
+WEAK int halide_error_batch_bounds_query(void *user_context, const char *func_name) {
+    error(user_context) << "The batched entry point " << func_name
+                        << " does not support bounds queries.\n";
+    return halide_error_code_batch_bounds_query;
+}
+
 }  // extern "C"
@@ -0,0 +1,158 @@
+#include "HalideRuntime.h"
+
+// The Linux allocator is the posix allocator, except that
+// allocations above a (configurable) size threshold are serviced
+// directly by mmap, aligned to the huge page size, and marked as
+// eligible for transparent huge pages. Very large intermediates
+// otherwise get 4K pages and miss in the TLB constantly.
+
+extern "C" {
+
+extern void *malloc(size_t);
+extern void free(void *);
+extern void *mmap(void *addr, size_t length, int prot, int flags, int fd, long offset);
+extern int munmap(void *addr, size_t length);
+extern int madvise(void *addr, size_t length, int advice);
+extern int getrusage(int who, void *usage);
+
+}
+
+// These values are the same on x86 and ARM, but not on all Linux
+// architectures (MAP_ANONYMOUS is 0x800 on MIPS), so this allocator
+// is only used on x86 and ARM. Other architectures get the posix
+// allocator.
+#define HALIDE_PROT_READ 0x1
+#define HALIDE_PROT_WRITE 0x2
+#define HALIDE_MAP_PRIVATE 0x02
+#define HALIDE_MAP_ANONYMOUS 0x20
+#define HALIDE_MAP_FAILED ((void *)-1)
+#define HALIDE_MADV_HUGEPAGE 14
+#define HALIDE_RUSAGE_SELF 0
+
+namespace Halide { namespace Runtime { namespace Internal {
+
+// The alignment of mmap'd allocations. This is the size of a huge
+// page on x86 and ARM.
+const size_t huge_page_size = 2 * 1024 * 1024;
+
+// Allocations of at least this many bytes go through mmap. Zero
+// means never.
+WEAK size_t huge_page_threshold = 0;
+WEAK bool huge_page_threshold_initialized = false;
+
+WEAK size_t get_huge_page_threshold() {
+    if (!huge_page_threshold_initialized) {
+        const char *threshold = getenv("HL_HUGE_PAGE_THRESHOLD");
+        if (threshold) {
+            huge_page_threshold = (size_t)atoi(threshold);
+        }
+        huge_page_threshold_initialized = true;
+    }
+    return huge_page_threshold;
+}
+
+// The parts of struct rusage we care about.
+struct halide_rusage {
+    long utime[2], stime[2];
+    long maxrss, ixrss, idrss, isrss, minflt, majflt;
+    long nswap, inblock, oublock, msgsnd, msgrcv, nsignals, nvcsw, nivcsw;
+};
+
+}}} // namespace Halide::Runtime::Internal
+
+extern "C" {
+
+// Every allocation stores two words before the pointer returned:
+// the original pointer, and the length of the mapping (or zero if
+// it came from malloc).
+WEAK void *halide_default_malloc(void *user_context, size_t x) {
+    size_t threshold = get_huge_page_threshold();
+    if (threshold && x >= threshold) {
+        // Round up to a whole number of huge pages, and leave one
+        // extra huge page for aligning the pointer we return and
+        // storing the header. The extra virtual memory is never
+        // touched, so it costs no physical memory.
+        size_t length = ((x + huge_page_size - 1) & ~(huge_page_size - 1)) + huge_page_size;
+        void *orig = mmap(NULL, length, HALIDE_PROT_READ | HALIDE_PROT_WRITE,
+                          HALIDE_MAP_PRIVATE | HALIDE_MAP_ANONYMOUS, -1, 0);
+        if (orig != HALIDE_MAP_FAILED) {
+            void *ptr = (void *)(((size_t)orig + huge_page_size) & ~(huge_page_size - 1));
+            // Failure here just means we get regular pages.
+            madvise(ptr, length - ((size_t)ptr - (size_t)orig), HALIDE_MADV_HUGEPAGE);
+            ((void **)ptr)[-1] = orig;
+            ((size_t *)ptr)[-2] = length;
+            return ptr;
+        }
+        // Fall back to malloc.
+    }
+
+    // Allocate enough space for aligning the pointer we return.
+    const size_t alignment = 128;
+    void *orig = malloc(x + alignment + sizeof(void *));
+    if (orig == NULL) {
+        // Will result in a failed assertion and a call to halide_error
+        return NULL;
+    }
+    // We want to store the original pointer prior to the pointer we return.
+    void *ptr = (void *)(((size_t)orig + alignment + 2 * sizeof(void*) - 1) & ~(alignment - 1));
+    ((void **)ptr)[-1] = orig;
+    ((size_t *)ptr)[-2] = 0;
+    return ptr;
+}
+
+WEAK void halide_default_free(void *user_context, void *ptr) {
+    void *orig = ((void **)ptr)[-1];
+    size_t length = ((size_t *)ptr)[-2];
+    if (length) {
+        munmap(orig, length);
+    } else {
+        free(orig);
+    }
+}
+
+WEAK size_t halide_set_huge_page_threshold(size_t threshold) {
+    size_t result = get_huge_page_threshold();
+    huge_page_threshold = threshold;
+    return result;
+}
+
+WEAK uint64_t halide_page_fault_count(void *user_context) {
+    halide_rusage usage;
+    if (getrusage(HALIDE_RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return (uint64_t)(usage.minflt + usage.majflt);
+}
+
+}
+
+namespace Halide { namespace Runtime { namespace Internal {
+
+WEAK halide_malloc_t custom_malloc = halide_default_malloc;
+WEAK halide_free_t custom_free = halide_default_free;
+
+}}} // namespace Halide::Runtime::Internal
+
+extern "C" {
+
+WEAK halide_malloc_t halide_set_custom_malloc(halide_malloc_t user_malloc) {
+    halide_malloc_t result = custom_malloc;
+    custom_malloc = user_malloc;
+    return result;
+}
+
+WEAK halide_free_t halide_set_custom_free(halide_free_t user_free) {
+    halide_free_t result = custom_free;
+    custom_free = user_free;
+    return result;
+}
+
+WEAK void *halide_malloc(void *user_context, size_t x) {
+    return custom_malloc(user_context, x);
+}
+
+WEAK void halide_free(void *user_context, void *ptr) {
+    custom_free(user_context, ptr);
+}
+
+}
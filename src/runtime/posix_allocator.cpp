@@ -23,6 +23,19 @@ WEAK void halide_default_free(void *user_context, void *ptr) {
     free(((void**)ptr)[-1]);
 }
 
+// Huge page allocation is not supported by this allocator, but we
+// track the threshold so that the setter behaves consistently.
+WEAK size_t halide_set_huge_page_threshold(size_t threshold) {
+    static size_t huge_page_threshold = 0;
+    size_t result = huge_page_threshold;
+    huge_page_threshold = threshold;
+    return result;
+}
+
+WEAK uint64_t halide_page_fault_count(void *user_context) {
+    return 0;
+}
+
 }
 
 namespace Halide { namespace Runtime { namespace Internal {
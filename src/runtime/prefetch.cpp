@@ -10,4 +10,31 @@ WEAK int _halide_prefetch(const void *ptr) {
     return 0;
 }
 
+// Variants for each PrefetchHint. The non-temporal ones use locality
+// zero, which brings the line in without displacing other data from
+// the outer caches where the target supports it.
+__attribute__((always_inline))
+WEAK int _halide_prefetch_read(const void *ptr) {
+    __builtin_prefetch(ptr, 0, 3);
+    return 0;
+}
+
+__attribute__((always_inline))
+WEAK int _halide_prefetch_write(const void *ptr) {
+    __builtin_prefetch(ptr, 1, 3);
+    return 0;
+}
+
+__attribute__((always_inline))
+WEAK int _halide_prefetch_read_nt(const void *ptr) {
+    __builtin_prefetch(ptr, 0, 0);
+    return 0;
+}
+
+__attribute__((always_inline))
+WEAK int _halide_prefetch_write_nt(const void *ptr) {
+    __builtin_prefetch(ptr, 1, 0);
+    return 0;
+}
+
 }
@@ -45,6 +45,7 @@ WEAK halide_profiler_pipeline_stats *find_or_create_pipeline(const char *pipelin
     p->num_allocs = 0;
     p->active_threads_numerator = 0;
     p->active_threads_denominator = 0;
+    p->page_faults = 0;
     p->funcs = (halide_profiler_func_stats *)malloc(num_funcs * sizeof(halide_profiler_func_stats));
     if (!p->funcs) {
         free(p);
@@ -60,13 +61,55 @@ WEAK halide_profiler_pipeline_stats *find_or_create_pipeline(const char *pipelin
         p->funcs[i].stack_peak = 0;
         p->funcs[i].active_threads_numerator = 0;
         p->funcs[i].active_threads_denominator = 0;
+        p->funcs[i].page_faults = 0;
     }
     s->first_free_id += num_funcs;
     s->pipelines = p;
     return p;
 }
 
-WEAK void bill_func(halide_profiler_state *s, int func_id, uint64_t time, int active_threads) {
+// Event counters used for profile-guided optimization. These are
+// kept separately from the pipeline stats so that they can be looked
+// up before the pipeline is started.
+struct profiler_counters {
+    const char *pipeline_name;
+    uint64_t *counts;
+    int num_counters;
+    profiler_counters *next;
+};
+
+WEAK profiler_counters *counters_list = NULL;
+
+// Write all the counters to the file named by HL_BRANCH_PROFILE, one
+// line per pipeline, in a form Halide can read back in when
+// compiling.
+WEAK void write_branch_profile(void *user_context) {
+    const char *filename = getenv("HL_BRANCH_PROFILE");
+    if (!filename || !counters_list) {
+        return;
+    }
+    void *f = fopen(filename, "w");
+    if (!f) {
+        error(user_context) << "Could not open branch profile " << filename << " for writing\n";
+        return;
+    }
+    char line_buf[128];
+    Printer<StringStreamPrinter, sizeof(line_buf)> sstr(user_context, line_buf);
+    for (profiler_counters *c = counters_list; c; c = c->next) {
+        sstr.clear();
+        sstr << c->pipeline_name << " " << c->num_counters;
+        fwrite(sstr.str(), sstr.size(), 1, f);
+        for (int i = 0; i < c->num_counters; i++) {
+            sstr.clear();
+            sstr << " " << c->counts[i];
+            fwrite(sstr.str(), sstr.size(), 1, f);
+        }
+        fwrite("\n", 1, 1, f);
+    }
+    fclose(f);
+}
+
+WEAK void bill_func(halide_profiler_state *s, int func_id, uint64_t time, uint64_t page_faults, int active_threads) {
     halide_profiler_pipeline_stats *p_prev = NULL;
     for (halide_profiler_pipeline_stats *p = s->pipelines; p;
          p = (halide_profiler_pipeline_stats *)(p->next)) {
@@ -79,9 +122,11 @@ WEAK void bill_func(halide_profiler_state *s, int func_id, uint64_t time, int ac
             }
             halide_profiler_func_stats *f = p->funcs + func_id - p->first_func_id;
             f->time += time;
+            f->page_faults += page_faults;
             f->active_threads_numerator += active_threads;
             f->active_threads_denominator += 1;
             p->time += time;
+            p->page_faults += page_faults;
             p->samples++;
             p->active_threads_numerator += active_threads;
             p->active_threads_denominator += 1;
@@ -102,6 +147,7 @@ WEAK void sampling_profiler_thread(void *) {
 
         uint64_t t1 = halide_current_time_ns(NULL);
         uint64_t t = t1;
+        uint64_t faults = halide_page_fault_count(NULL);
         while (1) {
             int func, active_threads;
             if (s->get_remote_profiler_state) {
@@ -113,14 +159,16 @@ WEAK void sampling_profiler_thread(void *) {
                 active_threads = s->active_threads;
             }
             uint64_t t_now = halide_current_time_ns(NULL);
+            uint64_t faults_now = halide_page_fault_count(NULL);
             if (func == halide_profiler_please_stop) {
                 break;
             } else if (func >= 0) {
-                // Assume all time since I was last awake is due to
-                // the currently running func.
-                bill_func(s, func, t_now - t, active_threads);
+                // Assume all time and page faults since I was last
+                // awake are due to the currently running func.
+                bill_func(s, func, t_now - t, faults_now - faults, active_threads);
             }
             t = t_now;
+            faults = faults_now;
 
             // Release the lock, sleep, reacquire.
             int sleep_ms = s->sleep_time;
@@ -171,6 +219,39 @@ WEAK halide_profiler_pipeline_stats *halide_profiler_get_pipeline_state(const ch
     return NULL;
 }
 
+// Returns the event counters for the given pipeline, creating them if
+// necessary.
+WEAK uint64_t *halide_profiler_get_counters(void *user_context,
+                                            const char *pipeline_name,
+                                            int num_counters) {
+    halide_profiler_state *s = halide_profiler_get_state();
+
+    ScopedMutexLock lock(&s->lock);
+
+    for (profiler_counters *c = counters_list; c; c = c->next) {
+        if (c->pipeline_name == pipeline_name &&
+            c->num_counters == num_counters) {
+            return c->counts;
+        }
+    }
+
+    profiler_counters *c = (profiler_counters *)malloc(sizeof(profiler_counters));
+    if (!c) {
+        return NULL;
+    }
+    c->counts = (uint64_t *)malloc(num_counters * sizeof(uint64_t));
+    if (!c->counts) {
+        free(c);
+        return NULL;
+    }
+    memset(c->counts, 0, num_counters * sizeof(uint64_t));
+    c->pipeline_name = pipeline_name;
+    c->num_counters = num_counters;
+    c->next = counters_list;
+    counters_list = c;
+    return c->counts;
+}
+
 // Returns a token identifying this pipeline instance.
 WEAK int halide_profiler_pipeline_start(void *user_context,
                                         const char *pipeline_name,
@@ -308,7 +389,11 @@ WEAK void halide_profiler_report_unlocked(void *user_context, halide_profiler_st
             sstr << " average threads used: " << threads << "\n";
         }
         sstr << " heap allocations: " << p->num_allocs
-             << "  peak heap usage: " << p->memory_peak << " bytes\n";
+             << "  peak heap usage: " << p->memory_peak << " bytes";
+        if (p->page_faults) {
+            sstr << "  page faults: " << p->page_faults;
+        }
+        sstr << "\n";
         halide_print(user_context, sstr.str());
 
         bool print_f_states = p->time || p->memory_total;
@@ -377,6 +462,9 @@ WEAK void halide_profiler_report_unlocked(void *user_context, halide_profiler_st
                 if (fs->stack_peak > 0) {
                     sstr << " stack: " << fs->stack_peak;
                 }
+                if (fs->page_faults > 0) {
+                    sstr << " faults: " << fs->page_faults;
+                }
                 sstr << "\n";
 
                 halide_print(user_context, sstr.str());
@@ -389,6 +477,7 @@ WEAK void halide_profiler_report(void *user_context) {
     halide_profiler_state *s = halide_profiler_get_state();
     ScopedMutexLock lock(&s->lock);
     halide_profiler_report_unlocked(user_context, s);
+    write_branch_profile(user_context);
 }
 
 
@@ -408,6 +497,13 @@ WEAK void halide_profiler_reset() {
         free(p);
     }
     s->first_free_id = 0;
+
+    while (counters_list) {
+        profiler_counters *c = counters_list;
+        counters_list = c->next;
+        free(c->counts);
+        free(c);
+    }
 }
 
 namespace {
@@ -425,6 +521,7 @@ WEAK void halide_profiler_shutdown() {
     // Print results. No need to lock anything because we just shut
     // down the thread.
     halide_profiler_report_unlocked(NULL, s);
+    write_branch_profile(NULL);
 
     // Leak the memory. Not all implementations of ScopedMutexLock may
     // be safe to use at static destruction time (windows).
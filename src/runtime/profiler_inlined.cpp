@@ -20,6 +20,14 @@ WEAK __attribute__((always_inline)) int halide_profiler_incr_active_threads(hali
     return ret;
 }
 
+WEAK __attribute__((always_inline)) int halide_profiler_incr_counter(uint64_t *counters, int idx) {
+    // The counters may be missing if we ran out of memory making them.
+    if (counters) {
+        __sync_fetch_and_add(counters + idx, 1);
+    }
+    return 0;
+}
+
 WEAK __attribute__((always_inline)) int halide_profiler_decr_active_threads(halide_profiler_state *state) {
     volatile int *ptr = &(state->active_threads);
     asm volatile ("":::);
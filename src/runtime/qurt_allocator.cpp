@@ -119,4 +119,14 @@ WEAK void halide_free(void *user_context, void *ptr) {
     halide_default_free(user_context, ptr);
 }
 
+// Huge pages aren't available on Hexagon, and QuRT doesn't report
+// page faults. These are needed by the profiler.
+WEAK size_t halide_set_huge_page_threshold(size_t threshold) {
+    return 0;
+}
+
+WEAK uint64_t halide_page_fault_count(void *user_context) {
+    return 0;
+}
+
 }
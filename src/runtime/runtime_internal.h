@@ -54,6 +54,9 @@ extern "C" {
 void *halide_malloc(void *user_context, size_t x);
 void halide_free(void *user_context, void *ptr);
 WEAK int64_t halide_current_time_ns(void *user_context);
+// The number of page faults incurred by this process so far, or zero
+// if the platform doesn't report them. Provided by the allocator.
+WEAK uint64_t halide_page_fault_count(void *user_context);
 WEAK void halide_print(void *user_context, const char *msg);
 WEAK void halide_error(void *user_context, const char *msg);
 WEAK void (*halide_set_custom_print(void (*print)(void *, const char *)))(void *, const char *);
@@ -134,6 +137,9 @@ WEAK int halide_profiler_pipeline_start(void *user_context,
                                         const char *pipeline_name,
                                         int num_funcs,
                                         const uint64_t *func_names);
+WEAK uint64_t *halide_profiler_get_counters(void *user_context,
+                                            const char *pipeline_name,
+                                            int num_counters);
 WEAK int halide_host_cpu_count();
 
 WEAK int halide_device_and_host_malloc(void *user_context, struct halide_buffer_t *buf,
@@ -0,0 +1,193 @@
+#include "Halide.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+// Count the branches, and how many of them are tagged as likely.
+class CountBranches : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const IfThenElse *op) {
+        branches++;
+        const Call *c = op->condition.as<Call>();
+        if (c && c->is_intrinsic(Call::likely)) {
+            likely_branches++;
+        }
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Call *op) {
+        if (op->name == "halide_profiler_incr_counter") {
+            counters++;
+        }
+        IRVisitor::visit(op);
+    }
+
+public:
+    int branches = 0, likely_branches = 0, counters = 0;
+};
+
+CountBranches count_branches(const Module &m) {
+    CountBranches counter;
+    for (const LoweredFunc &f : m.functions()) {
+        if (f.name == "branchy") {
+            f.body.accept(&counter);
+        }
+    }
+    return counter;
+}
+
+int check(const Buffer<int> &out, int scale) {
+    for (int y = 0; y < out.height(); y++) {
+        for (int x = 0; x < out.width(); x++) {
+            int correct = (x + y) * scale;
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    Var x, y;
+    Param<int> scale;
+    // Profiles are matched to pipelines by name, and JIT-compiled
+    // pipelines are named after their output.
+    Func g("branchy");
+    g(x, y) = (x + y) * scale;
+    // Each specialization is a branch.
+    g.specialize(scale == 1);
+    g.specialize(scale == 2).vectorize(x, 8);
+
+    Target t = get_jit_target_from_environment();
+
+    // Profiling without asking for a branch profile shouldn't count
+    // branches, as that would skew the timings.
+    CountBranches plain =
+        count_branches(Pipeline(g).compile_to_module({scale}, "branchy", t.with_feature(Target::Profile)));
+    if (plain.counters != 0) {
+        printf("Branches were counted without HL_BRANCH_PROFILE set\n");
+        return -1;
+    }
+
+    const char *filename = "branch_profile.txt";
+    static char env[] = "HL_BRANCH_PROFILE=branch_profile.txt";
+    putenv(env);
+    remove(filename);
+
+    // With no profile, nothing should be tagged.
+    CountBranches before = count_branches(Pipeline(g).compile_to_module({scale}, "branchy", t));
+    if (before.branches == 0) {
+        printf("Expected at least one branch\n");
+        return -1;
+    }
+    if (before.likely_branches != 0) {
+        printf("There should be no likely branches without a profile\n");
+        return -1;
+    }
+
+    // An instrumented build shouldn't change the number of branches.
+    CountBranches instrumented =
+        count_branches(Pipeline(g).compile_to_module({scale}, "branchy", t.with_feature(Target::Profile)));
+    if (instrumented.branches != before.branches) {
+        printf("Instrumented build has %d branches instead of %d\n",
+               instrumented.branches, before.branches);
+        return -1;
+    }
+    if (instrumented.counters != instrumented.branches * 2) {
+        printf("Instrumented build has %d branch counters instead of %d\n",
+               instrumented.counters, instrumented.branches * 2);
+        return -1;
+    }
+
+    // Run the instrumented pipeline. The profiler report at the end
+    // of each run writes the branch counts.
+    Target profiled = t.with_feature(Target::Profile);
+    scale.set(2);
+    for (int i = 0; i < 3; i++) {
+        Buffer<int> out = g.realize(64, 64, profiled);
+        if (check(out, 2)) {
+            return -1;
+        }
+    }
+
+    // Read the profile back in, and work out which branches it
+    // should cause to be tagged.
+    FILE *f_profile = fopen(filename, "r");
+    if (!f_profile) {
+        printf("The instrumented pipeline didn't write %s\n", filename);
+        return -1;
+    }
+    char name[64];
+    int num_counters = 0;
+    if (fscanf(f_profile, "%63s %d", name, &num_counters) != 2 ||
+        std::string(name) != "branchy" ||
+        num_counters != before.branches * 2) {
+        printf("%s doesn't start with a profile of the %d branches of branchy\n",
+               filename, before.branches);
+        return -1;
+    }
+    int expected_likely = 0;
+    for (int i = 0; i < before.branches; i++) {
+        unsigned long long taken, not_taken;
+        if (fscanf(f_profile, "%llu %llu", &taken, &not_taken) != 2) {
+            printf("%s has too few counters\n", filename);
+            return -1;
+        }
+        unsigned long long total = taken + not_taken;
+        if (total > 0 && (taken * 10 >= total * 9 || not_taken * 10 >= total * 9)) {
+            expected_likely++;
+        }
+    }
+    fclose(f_profile);
+    // scale is always 2, so at least the specializations always go
+    // the same way.
+    if (expected_likely == 0) {
+        printf("The profile has no branches that always go the same way\n");
+        return -1;
+    }
+
+    CountBranches tagged = count_branches(Pipeline(g).compile_to_module({scale}, "branchy", t));
+    if (tagged.branches != before.branches || tagged.likely_branches != expected_likely) {
+        printf("%d of %d branches tagged as likely from the collected profile instead of %d of %d\n",
+               tagged.likely_branches, tagged.branches, expected_likely, before.branches);
+        return -1;
+    }
+
+    // The tagged pipeline must still compute the right thing, whichever
+    // way the branches go.
+    for (int s : {2, 1, 3}) {
+        scale.set(s);
+        Buffer<int> out = g.realize(64, 64, t);
+        if (check(out, s)) {
+            return -1;
+        }
+    }
+
+    // Write a profile that says every branch nearly always goes the
+    // same way, and check every branch is tagged.
+    f_profile = fopen(filename, "w");
+    fprintf(f_profile, "branchy %d", before.branches * 2);
+    for (int i = 0; i < before.branches; i++) {
+        fprintf(f_profile, i % 2 ? " 1 100" : " 100 1");
+    }
+    fprintf(f_profile, "\n");
+    fclose(f_profile);
+
+    CountBranches after = count_branches(Pipeline(g).compile_to_module({scale}, "branchy", t));
+    if (after.branches != before.branches || after.likely_branches != before.branches) {
+        printf("%d of %d branches tagged as likely instead of %d of %d\n",
+               after.likely_branches, after.branches, before.branches, before.branches);
+        return -1;
+    }
+
+    remove(filename);
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+bool error_occurred = false;
+void my_error_handler(void *, const char *msg) {
+    error_occurred = true;
+}
+
+int main(int argc, char **argv) {
+    ImageParam input(Int(32), 2);
+    Param<int> offset;
+    Var x, y;
+
+    Func f;
+    f(x, y) = input(x + offset, y) * 2;
+    f.vectorize(x, 4);
+    f.set_error_handler(&my_error_handler);
+
+    // Skip the buffer checks while the shapes and params match those
+    // of the last call that passed them.
+    Target t = get_jit_target_from_environment().with_feature(Target::CheckCache);
+
+    Buffer<int> in(64, 16), small_in(16, 16);
+    in.for_each_element([&](int x, int y) { in(x, y) = x + y * 64; });
+    small_in.for_each_element([&](int x, int y) { small_in(x, y) = x + y * 16; });
+
+    auto run = [&](const Buffer<int> &buf, int off, bool expect_error) {
+        input.set(buf);
+        offset.set(off);
+        error_occurred = false;
+        Buffer<int> out = f.realize(32, 16, t);
+        if (error_occurred != expect_error) {
+            printf("Call with input width %d and offset %d %s\n",
+                   buf.width(), off, expect_error ? "should have failed" : "failed");
+            exit(-1);
+        }
+        if (!expect_error) {
+            out.for_each_element([&](int x, int y) {
+                int correct = buf(x + off, y) * 2;
+                if (out(x, y) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                    exit(-1);
+                }
+            });
+        }
+    };
+
+    // Repeated calls with the same shapes hit the cache.
+    for (int i = 0; i < 3; i++) {
+        run(in, 8, false);
+    }
+
+    // A change to a param the required region depends on must
+    // re-run the checks, even though the buffer shapes are the same.
+    run(in, 40, true);
+    run(in, 8, false);
+
+    // As must a change to the buffer shape.
+    run(small_in, 8, true);
+    run(in, 0, false);
+    run(small_in, 0, true);
+
+    printf("Success!\n");
+    return 0;
+}
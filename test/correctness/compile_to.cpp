@@ -1,5 +1,8 @@
 #include "Halide.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <sstream>
 
 #include "test/common/halide_test_dirs.h"
 
@@ -31,6 +34,32 @@ void testCompileToOutputAndAssembly(Func j) {
     Internal::assert_file_exists(fn_assembly);
 }
 
+void testCompileToPythonExtension(Func j) {
+    std::string fn_python = Internal::get_test_tmp_dir() + "compile_to_python.py.cpp";
+
+    Internal::ensure_no_file_exists(fn_python);
+
+    ImageParam in(Float(32), 2, "in");
+    Param<int> offset("offset");
+    j.compile_to(Outputs().python_extension(fn_python), {in, offset}, "compile_to_python");
+
+    Internal::assert_file_exists(fn_python);
+
+    // The module should call the pipeline through its argv entry
+    // point. Building and running the emitted source is tested by
+    // "make test_python_extension" in python_bindings.
+    std::ifstream file(fn_python);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    for (const char *expected : {"PyInit_compile_to_python", "compile_to_python_argv",
+                                 "compile_to_python_metadata", "compile_to_python(in, offset, "}) {
+        if (contents.str().find(expected) == std::string::npos) {
+            printf("Python extension source doesn't contain %s\n", expected);
+            exit(-1);
+        }
+    }
+}
+
 int main(int argc, char **argv) {
     Func f, g, h, j;
     Var x, y;
@@ -47,6 +76,8 @@ int main(int argc, char **argv) {
 
     testCompileToOutputAndAssembly(j);
 
+    testCompileToPythonExtension(j);
+
     printf("Success!\n");
     return 0;
 }
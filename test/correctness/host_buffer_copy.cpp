@@ -0,0 +1,79 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+// Check that copy_to_host can be used to express layout conversions
+// of host buffers (planar <-> interleaved, transposes, and crops),
+// which are implemented by halide_buffer_copy rather than by a Halide
+// loop nest.
+
+template<typename T>
+int check_copy() {
+    const int W = 37, H = 29, C = 3;
+
+    Buffer<T> planar(W, H, C);
+    planar.for_each_element([&](int x, int y, int c) {
+        planar(x, y, c) = (T)(x + y * 7 + c * 13);
+    });
+
+    Var x, y, c;
+
+    {
+        // Planar to interleaved
+        Func interleave, g;
+        interleave(x, y, c) = planar(x, y, c);
+        g(x, y, c) = interleave(x, y, c);
+        interleave.copy_to_host().compute_root().reorder_storage(c, x, y);
+
+        Buffer<T> out = g.realize(W, H, C);
+        for (int k = 0; k < C; k++) {
+            for (int j = 0; j < H; j++) {
+                for (int i = 0; i < W; i++) {
+                    if (out(i, j, k) != planar(i, j, k)) {
+                        printf("interleave: out(%d, %d, %d) = %d instead of %d\n",
+                               i, j, k, (int)out(i, j, k), (int)planar(i, j, k));
+                        return -1;
+                    }
+                }
+            }
+        }
+    }
+
+    {
+        // Transpose of a cropped region
+        Func transpose, g;
+        transpose(x, y, c) = planar(x, y, c);
+        g(x, y, c) = transpose(x, y, c);
+        transpose.copy_to_host().compute_root().reorder_storage(y, x, c);
+
+        Buffer<T> out(W - 4, H - 6, 2);
+        out.set_min(2, 3, 1);
+        g.realize(out);
+        for (int k = out.dim(2).min(); k <= out.dim(2).max(); k++) {
+            for (int j = out.dim(1).min(); j <= out.dim(1).max(); j++) {
+                for (int i = out.dim(0).min(); i <= out.dim(0).max(); i++) {
+                    if (out(i, j, k) != planar(i, j, k)) {
+                        printf("transpose: out(%d, %d, %d) = %d instead of %d\n",
+                               i, j, k, (int)out(i, j, k), (int)planar(i, j, k));
+                        return -1;
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (check_copy<uint8_t>() ||
+        check_copy<uint16_t>() ||
+        check_copy<float>() ||
+        check_copy<double>()) {
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include "Halide.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    // Service every allocation of at least 1MB with huge-page aligned
+    // memory (on platforms that support it). This must be set before
+    // the first allocation made by the runtime.
+    static char env[] = "HL_HUGE_PAGE_THRESHOLD=1048576";
+    putenv(env);
+
+    Var x, y;
+    Func f, g, h;
+
+    // f is large enough to go through the huge page path, g is not.
+    f(x, y) = x + y;
+    g(x, y) = f(x, y) * 2;
+    h(x, y) = g(x, y) + f(x + 1, y);
+
+    f.compute_root();
+    g.compute_at(h, y);
+
+    const int W = 2048, H = 1024;
+    for (int i = 0; i < 3; i++) {
+        Buffer<int> out = h.realize(W, H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                int correct = (x + y) * 2 + (x + 1 + y);
+                if (out(x, y) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -154,6 +154,48 @@ Func make_noise(int depth) {
     return f;
 }
 
+#ifndef _WIN32
+// Check that memory-mapped .tmp files round-trip through the regular loader.
+template<typename T>
+void test_mapped_tmp(Buffer<T> buf) {
+    std::string filename = Internal::get_test_tmp_dir() + "test_mapped.tmp";
+    Buffer<T> shifted(buf.width(), buf.height(), buf.channels());
+    shifted.set_min(buf.dim(0).min(), buf.dim(1).min(), buf.dim(2).min());
+    shifted.copy_from(buf);
+    shifted.set_min(0, 0, 0);
+
+    // Write it via a mapping
+    {
+        Runtime::Buffer<> mapped;
+        Tools::MappedFileHandle mapping;
+        if (!Tools::create_mapped_tmp(filename, halide_type_of<T>(),
+                                      {shifted.width(), shifted.height(), shifted.channels()},
+                                      &mapped, &mapping)) {
+            printf("test_mapped_tmp: create_mapped_tmp failed\n");
+            abort();
+        }
+        mapped.template as<T>().sliced(3, 0).copy_from(*shifted.get());
+    }
+
+    // Read it back both ways
+    Buffer<T> reloaded = Tools::load_image(filename);
+    Runtime::Buffer<> mapped;
+    Tools::MappedFileHandle mapping;
+    if (!Tools::map_tmp(filename, &mapped, &mapping)) {
+        printf("test_mapped_tmp: map_tmp failed\n");
+        abort();
+    }
+    Runtime::Buffer<T> mapped_t = mapped.template as<T>();
+    shifted.for_each_element([&](int x, int y, int c) {
+        if (reloaded(x, y, c, 0) != shifted(x, y, c) ||
+            mapped_t(x, y, c, 0) != shifted(x, y, c)) {
+            printf("test_mapped_tmp: Mismatch at %d %d %d\n", x, y, c);
+            abort();
+        }
+    });
+}
+#endif
+
 template<typename T>
 void do_test() {
     const int width = 1600;
@@ -176,6 +218,9 @@ void do_test() {
     test_convert_image_s2d<T>(color_buf);
     test_convert_image_d2s<T>(color_buf);
     test_convert_image_d2d<T>(color_buf);
+#ifndef _WIN32
+    test_mapped_tmp<T>(color_buf);
+#endif
 
     Buffer<T> luma_buf(width, height, 1);
     luma_buf.copy_from(color_buf);
@@ -0,0 +1,134 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+// Check there are no vector divisions left after lowering.
+class CheckNoVectorDivision : public IRMutator {
+    class Count : public IRVisitor {
+        using IRVisitor::visit;
+
+        void visit(const Div *op) {
+            if (op->type.is_vector()) {
+                count++;
+            }
+            IRVisitor::visit(op);
+        }
+
+        void visit(const Mod *op) {
+            if (op->type.is_vector()) {
+                count++;
+            }
+            IRVisitor::visit(op);
+        }
+
+    public:
+        int count = 0;
+    };
+
+public:
+    using IRMutator::mutate;
+
+    Stmt mutate(const Stmt &s) override {
+        Count c;
+        s.accept(&c);
+        if (c.count > 0) {
+            printf("There were %d vector divisions left:\n", c.count);
+            std::cout << s << "\n";
+            exit(-1);
+        }
+        return s;
+    }
+};
+
+template<typename T>
+T euclidean_div(T a, T b) {
+    if (std::is_unsigned<T>::value) {
+        return a / b;
+    }
+    int64_t q = (int64_t)a / (int64_t)b;
+    int64_t r = (int64_t)a - q * (int64_t)b;
+    if (r < 0) {
+        q += (b > 0) ? -1 : 1;
+    }
+    return (T)q;
+}
+
+template<typename T>
+T euclidean_mod(T a, T b) {
+    return (T)((int64_t)a - (int64_t)euclidean_div(a, b) * (int64_t)b);
+}
+
+template<typename T>
+int test(int vector_width) {
+    const int W = 256;
+    Buffer<T> input(W);
+    input.for_each_element([&](int x) {
+        input(x) = (T)rand();
+    });
+    // Cover the extremes of the type too.
+    input(0) = std::numeric_limits<T>::min();
+    input(1) = std::numeric_limits<T>::max();
+    input(2) = 0;
+
+    Param<T> divisor;
+    Func f;
+    Var x, c;
+    f(x, c) = select(c == 0, input(x) / divisor, input(x) % divisor);
+    f.bound(c, 0, 2).unroll(c).vectorize(x, vector_width);
+    f.add_custom_lowering_pass(new CheckNoVectorDivision);
+    f.compile_jit();
+
+    std::vector<T> divisors = {1, 2, 3, 7, 10, (T)255,
+                               std::numeric_limits<T>::max(),
+                               (T)(std::numeric_limits<T>::max() / 2 + 1)};
+    if (std::is_signed<T>::value) {
+        divisors.push_back((T)-1);
+        divisors.push_back((T)-3);
+        divisors.push_back(std::numeric_limits<T>::min());
+    }
+    for (int i = 0; i < 20; i++) {
+        T d = (T)rand();
+        if (d != 0) {
+            divisors.push_back(d);
+        }
+    }
+
+    for (T d : divisors) {
+        // Dividing the most negative value by -1 overflows.
+        if (std::is_signed<T>::value && d == (T)-1) {
+            input(0) = 0;
+        }
+        divisor.set(d);
+        Buffer<T> out = f.realize(W, 2);
+        for (int i = 0; i < W; i++) {
+            T q = euclidean_div(input(i), d);
+            T r = euclidean_mod(input(i), d);
+            if (out(i, 0) != q || out(i, 1) != r) {
+                printf("%s: %lld / %lld gave %lld, %lld instead of %lld, %lld\n",
+                       type_of<T>().is_int() ? "signed" : "unsigned",
+                       (long long)input(i), (long long)d,
+                       (long long)out(i, 0), (long long)out(i, 1),
+                       (long long)q, (long long)r);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (test<uint8_t>(16) ||
+        test<int8_t>(16) ||
+        test<uint16_t>(8) ||
+        test<int16_t>(8) ||
+        test<uint32_t>(4) ||
+        test<int32_t>(4) ||
+        test<int32_t>(8)) {
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
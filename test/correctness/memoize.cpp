@@ -613,6 +613,61 @@ int main(int argc, char **argv) {
 
     }
 
+    {
+        // A memoized output is copied out of the cache on a hit.
+        call_count_with_arg = 0;
+        Param<uint8_t> val;
+        Func f;
+        f.define_extern("count_calls_with_arg", {val}, UInt(8), 2);
+        f.memoize();
+
+        val.set(23);
+        Buffer<uint8_t> out1 = f.realize(64, 64);
+        Buffer<uint8_t> out2 = f.realize(64, 64);
+        val.set(24);
+        Buffer<uint8_t> out3 = f.realize(64, 64);
+
+        for (int32_t i = 0; i < 64; i++) {
+            for (int32_t j = 0; j < 64; j++) {
+                assert(out1(i, j) == 23);
+                assert(out2(i, j) == 23);
+                assert(out3(i, j) == 24);
+            }
+        }
+        assert(call_count_with_arg == 2);
+    }
+
+    {
+        // A Func stored outside its compute level is cached tile by
+        // tile, so a later request for some of the same tiles reuses
+        // them.
+        call_count_with_arg = 0;
+        Param<uint8_t> val;
+        Func f, g;
+        Var x, y, yo, yi;
+        f.define_extern("count_calls_with_arg", {val}, UInt(8), 2);
+        g(x, y) = f(x, y) + f(x - 1, y) + f(x + 1, y);
+        g.split(y, yo, yi, 16);
+        f.store_root().compute_at(g, yo).memoize();
+
+        val.set(23);
+        Buffer<uint8_t> out1 = g.realize(128, 128);
+        assert(call_count_with_arg == 8);
+        Buffer<uint8_t> out2 = g.realize(128, 128);
+        Buffer<uint8_t> out3 = g.realize(128, 64);
+        assert(call_count_with_arg == 8);
+
+        for (int32_t i = 0; i < 128; i++) {
+            for (int32_t j = 0; j < 128; j++) {
+                assert(out1(i, j) == (uint8_t)(3 * 23));
+                assert(out2(i, j) == (uint8_t)(3 * 23));
+                if (j < 64) {
+                    assert(out3(i, j) == (uint8_t)(3 * 23));
+                }
+            }
+        }
+    }
+
     fprintf(stderr, "Success!\n");
     return 0;
 }
@@ -0,0 +1,83 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+// Count the allocations made by the pipeline.
+int num_mallocs = 0;
+
+void *my_malloc(void *user_context, size_t x) {
+    num_mallocs++;
+    void *orig = malloc(x + 128);
+    void *ptr = (void *)((((size_t)orig + 128) >> 7) << 7);
+    ((void **)ptr)[-1] = orig;
+    return ptr;
+}
+
+void my_free(void *user_context, void *ptr) {
+    free(((void **)ptr)[-1]);
+}
+
+int main(int argc, char **argv) {
+    const int size = 100000;
+    const int stages = 7;
+
+    // A chain of compute_root stages, each of which is needed by the
+    // next two. Three of them are live at once, so they can all share
+    // three ranges of one slab.
+    Var x;
+    Param<int> offset;
+    std::vector<Func> f(stages);
+    f[0](x) = x + offset;
+    f[1](x) = f[0](x) * 2 + 1;
+    for (int i = 2; i < stages; i++) {
+        f[i](x) = f[i - 1](x) + f[i - 2](x) * 2 + i;
+    }
+    for (int i = 0; i < stages - 1; i++) {
+        f[i].compute_root().vectorize(x, 8);
+    }
+    f[stages - 1].bound(x, 0, size);
+    f[stages - 1].set_custom_allocator(my_malloc, my_free);
+
+    offset.set(3);
+
+    Target t = get_jit_target_from_environment();
+    int mallocs[2];
+    for (int plan = 0; plan < 2; plan++) {
+        num_mallocs = 0;
+
+        Target target = plan ? t.with_feature(Target::MemoryPlanning) : t.without_feature(Target::MemoryPlanning);
+        Buffer<int> out = f[stages - 1].realize(size, target);
+
+        for (int i = 0; i < size; i++) {
+            // Compute the expected value directly.
+            int v[stages];
+            v[0] = i + 3;
+            v[1] = v[0] * 2 + 1;
+            for (int s = 2; s < stages; s++) {
+                v[s] = v[s - 1] + v[s - 2] * 2 + s;
+            }
+            if (out(i) != v[stages - 1]) {
+                printf("With%s memory planning: out(%d) = %d instead of %d\n",
+                       plan ? "" : "out", i, out(i), v[stages - 1]);
+                return -1;
+            }
+        }
+
+        mallocs[plan] = num_mallocs;
+    }
+
+    if (mallocs[0] != stages - 1) {
+        printf("Expected %d allocations without memory planning, but there were %d\n",
+               stages - 1, mallocs[0]);
+        return -1;
+    }
+
+    if (mallocs[1] != 1) {
+        printf("Expected one slab allocation for the intermediates, but there were %d allocations\n", mallocs[1]);
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+// Count the vector arithmetic ops done on 32-bit integers.
+class CountWideArithmetic : public IRMutator {
+    class Count : public IRVisitor {
+        using IRVisitor::visit;
+
+        void check(Type t) {
+            if (t.is_vector() && t.bits() == 32 && (t.is_int() || t.is_uint())) {
+                count++;
+            }
+        }
+
+        void visit(const Add *op) {
+            check(op->type);
+            IRVisitor::visit(op);
+        }
+
+        void visit(const Sub *op) {
+            check(op->type);
+            IRVisitor::visit(op);
+        }
+
+        void visit(const Mul *op) {
+            check(op->type);
+            IRVisitor::visit(op);
+        }
+
+        void visit(const Div *op) {
+            check(op->type);
+            IRVisitor::visit(op);
+        }
+
+        void visit(const Min *op) {
+            check(op->type);
+            IRVisitor::visit(op);
+        }
+
+        void visit(const Max *op) {
+            check(op->type);
+            IRVisitor::visit(op);
+        }
+
+        void visit(const Load *op) {
+            // Don't count index arithmetic.
+        }
+
+    public:
+        int count = 0;
+    };
+
+public:
+    int count = 0;
+
+    using IRMutator::mutate;
+
+    Stmt mutate(const Stmt &s) override {
+        Count c;
+        s.accept(&c);
+        count = c.count;
+        return s;
+    }
+};
+
+int main(int argc, char **argv) {
+    const int W = 256, H = 16;
+    Buffer<uint8_t> input(W + 2, H);
+    input.for_each_element([&](int x, int y) {
+        input(x, y) = (uint8_t)rand();
+    });
+
+    Var x, y;
+    Func in;
+    // Written in int32 for convenience.
+    in(x, y) = cast<int>(input(x + 1, y));
+
+    Target t = get_jit_target_from_environment().with_feature(Target::NarrowArithmetic);
+
+    struct Test {
+        const char *name;
+        Expr e;
+        bool should_narrow;
+    } tests[] = {
+        // Fits in uint16.
+        {"blur", (in(x - 1, y) + 2 * in(x, y) + in(x + 1, y) + 2) / 4, true},
+        // Goes negative, but fits in int16.
+        {"sharpen", clamp(3 * in(x, y) - in(x - 1, y) - in(x + 1, y), 0, 255), true},
+        // Fits in uint8.
+        {"max", max(in(x - 1, y), in(x + 1, y)) - min(in(x - 1, y), in(x + 1, y)), true},
+        // Needs more than 16 bits.
+        {"product", in(x - 1, y) * in(x, y) * in(x + 1, y), false},
+    };
+
+    for (const Test &test : tests) {
+        Func f, reference;
+        f(x, y) = test.e;
+        reference(x, y) = test.e;
+        f.vectorize(x, 16);
+        reference.vectorize(x, 16);
+
+        CountWideArithmetic *counter = new CountWideArithmetic;
+        f.add_custom_lowering_pass(counter);
+        f.compile_jit(t);
+
+        Buffer<int> out = f.realize(W, H, t);
+        Buffer<int> correct = reference.realize(W, H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                if (out(x, y) != correct(x, y)) {
+                    printf("%s: out(%d, %d) = %d instead of %d\n",
+                           test.name, x, y, out(x, y), correct(x, y));
+                    return -1;
+                }
+            }
+        }
+
+        if (test.should_narrow && counter->count > 0) {
+            printf("%s: %d 32-bit vector ops were not narrowed\n", test.name, counter->count);
+            return -1;
+        }
+        if (!test.should_narrow && counter->count == 0) {
+            printf("%s: arithmetic that can overflow 16 bits was narrowed\n", test.name);
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "Halide.h"
+#include <stdio.h>
+#include <atomic>
+
+using namespace Halide;
+
+// Check that realize_streaming produces the same result as a regular
+// realize, while only ever asking for the part of the input each
+// strip needs.
+
+int input_value(int x, int y) {
+    return x * 3 + y * 5;
+}
+
+int main(int argc, char **argv) {
+    const int W = 123, H = 97, strip_size = 16;
+
+    ImageParam in(Int(32), 2, "in");
+    Var x, y;
+    Func f;
+    f(x, y) = in(x, y - 1) + 2 * in(x + 1, y) + in(x, y + 1);
+    f.parallel(y);
+
+    std::atomic<int> rows_read(0);
+    std::atomic<int> error(0);
+    auto reader = [&](const std::string &name, Buffer<> region) {
+        if (name != "in") {
+            printf("Reader called for unexpected input %s\n", name.c_str());
+            error = -1;
+        }
+        Buffer<int> buf = region;
+        buf.for_each_element([&](int x, int y) {
+            buf(x, y) = input_value(x, y);
+        });
+        rows_read += buf.height();
+        // Each strip needs one extra row above and below.
+        if (buf.height() > strip_size + 2) {
+            printf("Reader asked for %d rows for a strip of %d\n", buf.height(), strip_size);
+            error = -1;
+        }
+    };
+
+    int next_row = 0;
+    auto sink = [&](Realization r) {
+        Buffer<int> strip = r[0];
+        if (strip.dim(1).min() != next_row) {
+            printf("Strip starts at row %d instead of %d\n", strip.dim(1).min(), next_row);
+            error = -1;
+        }
+        strip.for_each_element([&](int x, int y) {
+            int correct = (input_value(x, y - 1) +
+                           2 * input_value(x + 1, y) +
+                           input_value(x, y + 1));
+            if (strip(x, y) != correct && !error) {
+                printf("out(%d, %d) = %d instead of %d\n", x, y, strip(x, y), correct);
+                error = -1;
+            }
+        });
+        next_row = strip.dim(1).max() + 1;
+    };
+
+    Pipeline(f).realize_streaming({W, H}, strip_size, reader, sink);
+
+    if (error) {
+        return -1;
+    }
+
+    if (next_row != H) {
+        printf("Only %d of %d rows were produced\n", next_row, H);
+        return -1;
+    }
+
+    // Every strip reads an overlap of two rows.
+    int expected_rows_read = H + 2 * ((H + strip_size - 1) / strip_size);
+    if (rows_read != expected_rows_read) {
+        printf("Read %d rows of input instead of %d\n", (int)rows_read, expected_rows_read);
+        return -1;
+    }
+
+    if (in.get().defined()) {
+        printf("Input should be unbound after realize_streaming\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
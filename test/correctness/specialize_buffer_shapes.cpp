@@ -0,0 +1,70 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+class CountIfThenElse : public IRVisitor {
+    using IRVisitor::visit;
+    void visit(const IfThenElse *op) {
+        count++;
+        IRVisitor::visit(op);
+    }
+public:
+    int count = 0;
+};
+
+int count_branches(Func f, ImageParam in) {
+    Module m = Pipeline(f).compile_to_module({in}, "f", get_jit_target_from_environment());
+    CountIfThenElse counter;
+    for (const LoweredFunc &fn : m.functions()) {
+        fn.body.accept(&counter);
+    }
+    return counter.count;
+}
+
+int main(int argc, char **argv) {
+    ImageParam in(Int(32), 2);
+    Var x, y;
+    Func f;
+    f(x, y) = in(x, y) * 2 + in(x, y) / 3;
+    f.vectorize(x, 8);
+
+    int general_branches = count_branches(f, in);
+
+    // Specialize on a 100x50 input with tightly packed rows. 100 is
+    // not a multiple of the vector width, so the general path needs a
+    // tail, but the specialized path does not.
+    in.dim(0).specialize_extent(100).dim(1).specialize_extent(50).specialize_stride(100);
+    f.output_buffer().dim(0).specialize_extent(100);
+
+    if (count_branches(f, in) <= general_branches) {
+        printf("Expected the pipeline to be specialized on buffer shapes\n");
+        return -1;
+    }
+
+    // Both the specialized and the general paths must produce the
+    // right answer.
+    int sizes[][2] = {{100, 50}, {37, 13}, {100, 51}};
+    for (auto &sz : sizes) {
+        Buffer<int> input(sz[0], sz[1]);
+        input.for_each_element([&](int x, int y) {
+            input(x, y) = x * 17 + y * 3;
+        });
+        in.set(input);
+        Buffer<int> out = f.realize(sz[0], sz[1]);
+        for (int j = 0; j < out.height(); j++) {
+            for (int i = 0; i < out.width(); i++) {
+                int correct = input(i, j) * 2 + input(i, j) / 3;
+                if (out(i, j) != correct) {
+                    printf("out(%d, %d) = %d instead of %d for a %dx%d input\n",
+                           i, j, out(i, j), correct, sz[0], sz[1]);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
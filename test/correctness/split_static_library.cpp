@@ -0,0 +1,99 @@
+#include "Halide.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <string>
+
+#include "test/common/halide_test_dirs.h"
+
+using namespace Halide;
+
+// Count the objects in a GNU or BSD archive, skipping the symbol and
+// string tables.
+int count_archive_members(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[8];
+    if (!file.read(magic, 8) || std::string(magic, 8) != "!<arch>\n") {
+        printf("%s is not an archive\n", path.c_str());
+        exit(-1);
+    }
+
+    int members = 0;
+    char header[60];
+    while (file.read(header, 60)) {
+        std::string name(header, 16);
+        name = name.substr(0, name.find_last_not_of(' ') + 1);
+        long size = strtol(std::string(header + 48, 10).c_str(), nullptr, 10);
+        long data_size = size;
+        if (name.compare(0, 3, "#1/") == 0) {
+            // BSD long names are stored at the start of the data.
+            long name_size = strtol(name.c_str() + 3, nullptr, 10);
+            std::string long_name(name_size, '\0');
+            file.read(&long_name[0], name_size);
+            name = long_name.c_str();
+            data_size -= name_size;
+        }
+        if (name != "/" && name.compare(0, 2, "//") != 0 &&
+            name.compare(0, 7, "/SYM64/") != 0 &&
+            name.compare(0, 9, "__.SYMDEF") != 0) {
+            members++;
+        }
+        file.seekg(data_size + (size & 1), std::ios::cur);
+    }
+    return members;
+}
+
+int check_members(const Module &m, const std::string &name, int expected) {
+    std::string lib = Internal::get_test_tmp_dir() + name + (m.target().os == Target::Windows ? ".lib" : ".a");
+    Internal::ensure_no_file_exists(lib);
+    m.compile(Outputs().static_library(lib));
+    Internal::assert_file_exists(lib);
+
+    int members = count_archive_members(lib);
+    if (members != expected) {
+        printf("Expected %s to contain %d objects, but it contains %d\n",
+               lib.c_str(), expected, members);
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    Var x, y;
+    ImageParam in(Int(32), 2, "in");
+
+    Func f("f");
+    f(x, y) = in(x, y) * 2;
+    f.parallel(y).vectorize(x, 8);
+
+    Func g("g");
+    g(x, y) = in(x, y) + in(x + 1, y);
+    g.parallel(y);
+
+    Target t = get_target_from_environment();
+
+    for (bool with_runtime : {false, true}) {
+        Target target = with_runtime ? t.without_feature(Target::NoRuntime) : t.with_feature(Target::NoRuntime);
+        std::string suffix = with_runtime ? "_runtime" : "_no_runtime";
+
+        // Each function gets its own object, and so does the runtime.
+        Module two = Pipeline(f).compile_to_module({in}, "split_f", target);
+        Module other = Pipeline(g).compile_to_module({in}, "split_g", target);
+        for (const auto &fn : other.functions()) {
+            two.append(fn);
+        }
+        if (check_members(two, "split_two" + suffix, with_runtime ? 3 : 2) != 0) {
+            return -1;
+        }
+
+        // A single function is still one object, alongside the
+        // runtime if there is one.
+        Module one = Pipeline(f).compile_to_module({in}, "split_f", target);
+        if (check_members(one, "split_one" + suffix, with_runtime ? 2 : 1) != 0) {
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+// Check all vector loads from a Func are dense.
+class CheckDenseLoads : public IRMutator {
+    class Check : public IRVisitor {
+        using IRVisitor::visit;
+
+        void visit(const Load *op) {
+            if (op->name == name && op->type.is_vector()) {
+                const Ramp *r = op->index.as<Ramp>();
+                if (!r || !is_one(r->stride)) {
+                    std::cout << "Load from " << name << " is not dense: " << Expr(op) << "\n";
+                    failed = true;
+                }
+                vector_loads++;
+            }
+            IRVisitor::visit(op);
+        }
+
+    public:
+        std::string name;
+        bool failed = false;
+        int vector_loads = 0;
+    };
+
+public:
+    std::string name;
+    bool failed = false;
+    int vector_loads = 0;
+
+    CheckDenseLoads(const std::string &name) : name(name) {}
+
+    using IRMutator::mutate;
+
+    Stmt mutate(const Stmt &s) override {
+        Check c;
+        c.name = name;
+        s.accept(&c);
+        failed = c.failed;
+        vector_loads = c.vector_loads;
+        return s;
+    }
+};
+
+int main(int argc, char **argv) {
+    const int W = 100, H = 70;
+    Buffer<int> input(W, H);
+    input.for_each_element([&](int x, int y) {
+        input(x, y) = rand() & 0xff;
+    });
+
+    Var x, y, xo, yo, xi, yi;
+
+    struct Test {
+        const char *name;
+        Func staged, inlined;
+    } tests[] = {
+        {"constant_exterior",
+         BoundaryConditions::constant_exterior(input, 17),
+         BoundaryConditions::constant_exterior(input, 17)},
+        {"repeat_edge",
+         BoundaryConditions::repeat_edge(input),
+         BoundaryConditions::repeat_edge(input)},
+        {"repeat_image",
+         BoundaryConditions::repeat_image(input),
+         BoundaryConditions::repeat_image(input)},
+        {"mirror_image",
+         BoundaryConditions::mirror_image(input),
+         BoundaryConditions::mirror_image(input)},
+        {"mirror_interior",
+         BoundaryConditions::mirror_interior(input),
+         BoundaryConditions::mirror_interior(input)},
+    };
+
+    for (Test &test : tests) {
+        // A 3x3 box filter, evaluated over a region larger than the
+        // input, so that some tiles are entirely outside it.
+        Expr staged_sum = 0, inlined_sum = 0;
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                staged_sum += test.staged(x + dx, y + dy);
+                inlined_sum += test.inlined(x + dx, y + dy);
+            }
+        }
+
+        Func staged_out, reference;
+        staged_out(x, y) = staged_sum;
+        reference(x, y) = inlined_sum;
+        staged_out.tile(x, y, xo, yo, xi, yi, 16, 16).vectorize(xi, 8);
+        BoundaryConditions::stage_padded(test.staged, LoopLevel(staged_out, xo), 8);
+
+        CheckDenseLoads *checker = new CheckDenseLoads(test.staged.name());
+        staged_out.add_custom_lowering_pass(checker);
+
+        Buffer<int> out(W + 40, H + 40);
+        out.set_min(-20, -20);
+        staged_out.realize(out);
+
+        Buffer<int> correct(W + 40, H + 40);
+        correct.set_min(-20, -20);
+        reference.realize(correct);
+
+        if (checker->failed) {
+            printf("%s: consumers of the staging buffer used gathers\n", test.name);
+            return -1;
+        }
+        if (checker->vector_loads == 0) {
+            printf("%s: no vector loads from the staging buffer\n", test.name);
+            return -1;
+        }
+
+        for (int y = out.dim(1).min(); y <= out.dim(1).max(); y++) {
+            for (int x = out.dim(0).min(); x <= out.dim(0).max(); x++) {
+                if (out(x, y) != correct(x, y)) {
+                    printf("%s: out(%d, %d) = %d instead of %d\n",
+                           test.name, x, y, out(x, y), correct(x, y));
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
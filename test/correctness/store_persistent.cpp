@@ -0,0 +1,96 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+// Count how many frames of video get processed.
+int frames_processed = 0;
+
+extern "C" DLLEXPORT int process_frames(halide_buffer_t *in, halide_buffer_t *out) {
+    if (in->is_bounds_query()) {
+        for (int i = 0; i < out->dimensions; i++) {
+            in->dim[i].min = out->dim[i].min;
+            in->dim[i].extent = out->dim[i].extent;
+        }
+    } else if (!out->is_bounds_query()) {
+        frames_processed += out->dim[2].extent;
+        Halide::Runtime::Buffer<int> out_buf(*out), in_buf(*in);
+        out_buf.for_each_value([&](int &out, int &in) {out = in * 2;}, in_buf);
+    }
+    return 0;
+}
+
+int frame_value(int x, int y, int t) {
+    return x + y * 10 + t * 100;
+}
+
+int main(int argc, char **argv) {
+    const int W = 32, H = 16, window = 3;
+
+    // A temporal filter over the last few frames of a video. Each
+    // invocation binds the window of frames ending at frame n.
+    ImageParam frames(Int(32), 3);
+    Param<int> n;
+    Var x, y, t;
+    RDom r(0, window);
+
+    Func processed;
+    processed.define_extern("process_frames", {frames}, Int(32), 3);
+
+    Func out;
+    out(x, y) = 0;
+    out(x, y) += processed(x, y, n - r);
+
+    // Compute one frame at a time, and keep the results around for
+    // the next invocation.
+    out.update().reorder(x, y, r);
+    processed.compute_at(out, r).store_persistent();
+
+    Internal::JITSharedRuntime::memoization_cache_set_size(1000000);
+
+    for (int frame = window - 1; frame < 10; frame++) {
+        Buffer<int> input(W, H, window);
+        input.set_min(0, 0, frame - window + 1);
+        input.for_each_element([&](int x, int y, int t) {
+            input(x, y, t) = frame_value(x, y, t);
+        });
+        frames.set(input);
+        n.set(frame);
+
+        frames_processed = 0;
+        Buffer<int> result = out.realize(W, H);
+
+        int expected_frames = frame == window - 1 ? window : 1;
+        if (frames_processed != expected_frames) {
+            printf("Processed %d frames for frame %d instead of %d\n",
+                   frames_processed, frame, expected_frames);
+            return -1;
+        }
+
+        for (int j = 0; j < H; j++) {
+            for (int i = 0; i < W; i++) {
+                int correct = 0;
+                for (int k = 0; k < window; k++) {
+                    correct += 2 * frame_value(i, j, frame - k);
+                }
+                if (result(i, j) != correct) {
+                    printf("result(%d, %d) = %d instead of %d for frame %d\n",
+                           i, j, result(i, j), correct, frame);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    // Return cache size to default.
+    Internal::JITSharedRuntime::memoization_cache_set_size(0);
+
+    printf("Success!\n");
+    return 0;
+}
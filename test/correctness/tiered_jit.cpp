@@ -0,0 +1,77 @@
+#include "Halide.h"
+#include <stdio.h>
+#include <chrono>
+#include <thread>
+
+using namespace Halide;
+
+int check(const Buffer<int> &out, const Buffer<int> &in) {
+    for (int y = 0; y < out.height(); y++) {
+        for (int x = 0; x < out.width(); x++) {
+            int correct = (in(x, y) + in(x + 1, y) + in(x + 2, y)) / 2;
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    Buffer<int> in(258, 256);
+    in.for_each_element([&](int x, int y) {
+        in(x, y) = x * 3 + y;
+    });
+
+    Var x, y;
+    Func f;
+    f(x, y) = (in(x, y) + in(x + 1, y) + in(x + 2, y)) / 2;
+    f.vectorize(x, 8).parallel(y);
+
+    Pipeline p(f);
+    p.set_tiered_jit(true);
+
+    Target target = get_jit_target_from_environment();
+
+    // The first calls use the quickly-compiled code, and at some
+    // point switch over to the optimized code, which shows up as a
+    // change of entry point. Results should be identical throughout.
+    void *fast_entry = p.compile_jit(target);
+    void *entry = fast_entry;
+    for (int i = 0; entry == fast_entry; i++) {
+        if (i == 1200) {
+            printf("The optimized module was never installed\n");
+            return -1;
+        }
+        Buffer<int> out = p.realize(256, 256, target);
+        if (check(out, in)) {
+            return -1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        entry = p.compile_jit(target);
+    }
+
+    // Once installed, the optimized module stays in use.
+    for (int i = 0; i < 3; i++) {
+        Buffer<int> out = p.realize(256, 256, target);
+        if (check(out, in)) {
+            return -1;
+        }
+        if (p.compile_jit(target) != entry) {
+            printf("The optimized module was replaced\n");
+            return -1;
+        }
+    }
+
+    // Code compiled with fast_compile alone should also be correct.
+    Target t = get_jit_target_from_environment().with_feature(Target::FastCompile);
+    p.set_tiered_jit(false);
+    Buffer<int> out = p.realize(256, 256, t);
+    if (check(out, in)) {
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
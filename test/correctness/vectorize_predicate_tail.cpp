@@ -0,0 +1,95 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+class CountStores : public IRVisitor {
+public:
+    int predicated = 0, scalar = 0;
+
+protected:
+    using IRVisitor::visit;
+
+    void visit(const Store *op) {
+        if (!is_one(op->predicate)) {
+            predicated++;
+        }
+        if (op->value.type().is_scalar()) {
+            scalar++;
+        }
+        IRVisitor::visit(op);
+    }
+};
+
+class CheckStores : public IRMutator {
+    bool expect_predicated;
+public:
+    CheckStores(bool p) : expect_predicated(p) {}
+    using IRMutator::mutate;
+
+    Stmt mutate(const Stmt &s) override {
+        CountStores c;
+        s.accept(&c);
+        if (expect_predicated) {
+            if (c.predicated == 0) {
+                printf("There should be some predicated stores but didn't find any\n");
+                exit(-1);
+            }
+            if (c.scalar > 0) {
+                printf("There were %d scalar stores in the tail\n", c.scalar);
+                exit(-1);
+            }
+        }
+        return s;
+    }
+};
+
+template<typename T>
+int test(int bits, bool expect_predicated) {
+    const int W = 100, H = 10;
+    Buffer<T> input(W, H);
+    input.for_each_element([&](int x, int y) {
+        input(x, y) = (T)(x * 3 + y);
+    });
+
+    Func f;
+    Var x, y;
+    f(x, y) = input(x, y) * 2 + 1;
+    f.vectorize(x, 16, TailStrategy::Predicate);
+    f.add_custom_lowering_pass(new CheckStores(expect_predicated));
+
+    Buffer<T> out = f.realize(W, H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            T correct = (T)(input(x, y) * 2 + 1);
+            if (out(x, y) != correct) {
+                printf("%d-bit: out(%d, %d) = %f instead of %f\n",
+                       bits, x, y, (double)out(x, y), (double)correct);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    Target t = get_jit_target_from_environment();
+    bool x86 = t.arch == Target::X86;
+    bool avx512bw = x86 && t.features_any_of({Target::AVX512_Skylake, Target::AVX512_Cannonlake});
+    bool avx = x86 && t.features_any_of({Target::AVX, Target::AVX2, Target::AVX512,
+                                         Target::AVX512_KNL, Target::AVX512_Skylake,
+                                         Target::AVX512_Cannonlake});
+
+    // Without hardware support for the lane size, the tail should
+    // still be correct, but may be scalarized.
+    if (test<uint8_t>(8, avx512bw) ||
+        test<uint16_t>(16, avx512bw) ||
+        test<int32_t>(32, x86) ||
+        test<double>(64, avx)) {
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
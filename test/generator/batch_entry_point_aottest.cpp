@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "HalideRuntime.h"
+#include "HalideBuffer.h"
+
+#include "batch_entry_point.h"
+
+using namespace Halide::Runtime;
+
+void my_halide_error(void *user_context, const char *msg) {
+    // Silently drop the error
+}
+
+int main(int argc, char **argv) {
+    const int W = 64, H = 16, N = 8;
+
+    Buffer<int32_t> input(W, H, N), output(W, H, N);
+    input.for_each_element([&](int x, int y, int n) {
+        input(x, y, n) = x + y * W + n * W * H;
+    });
+
+    // The batched entry point processes every item of the outermost
+    // dimension.
+    int result = batch_entry_point_batch(input, 3, output);
+    if (result != 0) {
+        printf("batch_entry_point_batch failed: %d\n", result);
+        return -1;
+    }
+    output.for_each_element([&](int x, int y, int n) {
+        int correct = input(x, y, n) * 2 + 3;
+        if (output(x, y, n) != correct) {
+            printf("output(%d, %d, %d) = %d instead of %d\n", x, y, n, output(x, y, n), correct);
+            exit(-1);
+        }
+    });
+
+    // A batch dimension with a non-zero min works too, and each item
+    // matches a call to the unbatched entry point.
+    Buffer<int32_t> shifted_input = input.cropped(2, 2, 4);
+    Buffer<int32_t> shifted_output(W, H, 4);
+    shifted_output.set_min(0, 0, 2);
+    result = batch_entry_point_batch(shifted_input, 5, shifted_output);
+    if (result != 0) {
+        printf("batch_entry_point_batch failed: %d\n", result);
+        return -1;
+    }
+    for (int n = 2; n < 6; n++) {
+        Buffer<int32_t> single(W, H);
+        result = batch_entry_point(input.sliced(2, n), 5, single);
+        if (result != 0) {
+            printf("batch_entry_point failed: %d\n", result);
+            return -1;
+        }
+        single.for_each_element([&](int x, int y) {
+            if (shifted_output(x, y, n) != single(x, y)) {
+                printf("shifted_output(%d, %d, %d) = %d instead of %d\n",
+                       x, y, n, shifted_output(x, y, n), single(x, y));
+                exit(-1);
+            }
+        });
+    }
+
+    // The arguments are checked once for the whole batch, not for
+    // each item. Items of a 5x3 input are 60 bytes apart, so all but
+    // the first are misaligned, and the unbatched entry point rejects
+    // them. The batched entry point still runs them.
+    const int small_W = 5, small_H = 3;
+    Buffer<int32_t> small_input(small_W, small_H, N), small_output(small_W, small_H, N);
+    small_input.for_each_element([&](int x, int y, int n) {
+        small_input(x, y, n) = x + y * small_W + n * small_W * small_H;
+    });
+    halide_set_error_handler(&my_halide_error);
+    Buffer<int32_t> single(small_W, small_H);
+    result = batch_entry_point(small_input.sliced(2, 1), 7, single);
+    if (result != halide_error_code_unaligned_host_ptr) {
+        printf("Expected halide_error_code_unaligned_host_ptr, got %d\n", result);
+        return -1;
+    }
+    result = batch_entry_point_batch(small_input, 7, small_output);
+    if (result != 0) {
+        printf("batch_entry_point_batch failed: %d\n", result);
+        return -1;
+    }
+    small_output.for_each_element([&](int x, int y, int n) {
+        int correct = small_input(x, y, n) * 2 + 7;
+        if (small_output(x, y, n) != correct) {
+            printf("small_output(%d, %d, %d) = %d instead of %d\n", x, y, n, small_output(x, y, n), correct);
+            exit(-1);
+        }
+    });
+
+    // But the first item is checked: a misaligned batch is rejected.
+    Buffer<int32_t> shifted_batch = small_input.cropped(2, 1, N - 1);
+    Buffer<int32_t> shifted_batch_output(small_W, small_H, N - 1);
+    shifted_batch_output.set_min(0, 0, 1);
+    result = batch_entry_point_batch(shifted_batch, 7, shifted_batch_output);
+    if (result != halide_error_code_unaligned_host_ptr) {
+        printf("Expected halide_error_code_unaligned_host_ptr, got %d\n", result);
+        return -1;
+    }
+
+    // Buffers that disagree about the batch dimension are rejected.
+    Buffer<int32_t> short_output(W, H, N - 1);
+    result = batch_entry_point_batch(input, 3, short_output);
+    if (result != halide_error_code_bad_batch_dimension) {
+        printf("Expected halide_error_code_bad_batch_dimension, got %d\n", result);
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
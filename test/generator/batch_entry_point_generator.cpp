@@ -0,0 +1,30 @@
+#include "Halide.h"
+
+namespace {
+
+class BatchEntryPoint : public Halide::Generator<BatchEntryPoint> {
+public:
+    Input<Buffer<int32_t>> input{ "input", 2 };
+    Input<int32_t> offset{ "offset" };
+
+    Output<Buffer<int32_t>> output{ "output", 2 };
+
+    void generate() {
+        output(x, y) = input(x, y) * 2 + offset;
+    }
+
+    void schedule() {
+        // The unbatched entry point rejects inputs that aren't aligned
+        // to 64 bytes. The batched one only checks the first item, so
+        // the others can be misaligned. Nothing loads the input as a
+        // vector, so no code depends on the alignment.
+        input.set_host_alignment(64);
+    }
+
+private:
+    Var x{"x"}, y{"y"};
+};
+
+}  // namespace
+
+HALIDE_REGISTER_GENERATOR(BatchEntryPoint, batch_entry_point)
@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "HalideRuntime.h"
+#include "HalideBuffer.h"
+
+#include "specialize_buffer_shapes.h"
+
+using namespace Halide::Runtime;
+
+int main(int argc, char **argv) {
+    // The first size matches the shape the pipeline was specialized
+    // on; the others take the general path.
+    int sizes[][2] = {{96, 50}, {37, 13}, {96, 51}, {100, 50}};
+    for (auto &sz : sizes) {
+        Buffer<int32_t> input(sz[0], sz[1]), output(sz[0], sz[1]);
+        input.for_each_element([&](int x, int y) {
+            input(x, y) = x * 17 + y * 3;
+        });
+
+        int result = specialize_buffer_shapes(input, output);
+        if (result != 0) {
+            printf("specialize_buffer_shapes failed: %d\n", result);
+            return -1;
+        }
+        output.for_each_element([&](int x, int y) {
+            int correct = input(x, y) * 2 + input(x, y) / 3;
+            if (output(x, y) != correct) {
+                printf("output(%d, %d) = %d instead of %d for a %dx%d input\n",
+                       x, y, output(x, y), correct, sz[0], sz[1]);
+                exit(-1);
+            }
+        });
+    }
+
+    // A 96x50 crop of a wider image has the right extents but not the
+    // right row stride, so it must also take the general path.
+    Buffer<int32_t> wide(128, 50);
+    wide.for_each_element([&](int x, int y) {
+        wide(x, y) = x * 17 + y * 3;
+    });
+    Buffer<int32_t> input = wide.cropped(0, 0, 96);
+    Buffer<int32_t> output(96, 50);
+    int result = specialize_buffer_shapes(input, output);
+    if (result != 0) {
+        printf("specialize_buffer_shapes failed: %d\n", result);
+        return -1;
+    }
+    output.for_each_element([&](int x, int y) {
+        int correct = input(x, y) * 2 + input(x, y) / 3;
+        if (output(x, y) != correct) {
+            printf("output(%d, %d) = %d instead of %d for a cropped input\n",
+                   x, y, output(x, y), correct);
+            exit(-1);
+        }
+    });
+
+    printf("Success!\n");
+    return 0;
+}
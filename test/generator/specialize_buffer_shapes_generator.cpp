@@ -0,0 +1,33 @@
+#include "Halide.h"
+
+namespace {
+
+// Built with input.extents=96,50 input.strides=1,96, so the pipeline
+// is specialized on a tightly packed 96x50 input.
+class SpecializeBufferShapes : public Halide::Generator<SpecializeBufferShapes> {
+public:
+    Input<Buffer<int32_t>> input{ "input", 2 };
+
+    Output<Buffer<int32_t>> output{ "output", 2 };
+
+    void generate() {
+        output(x, y) = input(x, y) * 2 + input(x, y) / 3;
+    }
+
+    void schedule() {
+        // The output has the same shape as the input, so specializing
+        // the input's extents also fixes the output loop bounds. 96
+        // is a multiple of the vector width, so the specialized path
+        // needs no tail.
+        output.dim(0).set_bounds(input.dim(0).min(), input.dim(0).extent());
+        output.dim(1).set_bounds(input.dim(1).min(), input.dim(1).extent());
+        output.vectorize(x, 8, TailStrategy::GuardWithIf);
+    }
+
+private:
+    Var x{"x"}, y{"y"};
+};
+
+}  // namespace
+
+HALIDE_REGISTER_GENERATOR(SpecializeBufferShapes, specialize_buffer_shapes)
@@ -0,0 +1,97 @@
+#include "Halide.h"
+
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+// Find the outermost branch on the input's shape.
+class FindSpecialization : public IRVisitor {
+    using IRVisitor::visit;
+
+    bool mentions_input_extent = false;
+
+    void visit(const Variable *op) {
+        if (op->name == "input.extent.0") {
+            mentions_input_extent = true;
+        }
+    }
+
+    void visit(const IfThenElse *op) {
+        if (!result) {
+            mentions_input_extent = false;
+            op->condition.accept(this);
+            if (mentions_input_extent) {
+                result = op;
+                return;
+            }
+        }
+        IRVisitor::visit(op);
+    }
+
+public:
+    const IfThenElse *result = nullptr;
+};
+
+class CountLoops : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const For *op) {
+        loops++;
+        if (!is_const(op->extent)) {
+            non_constant_extents++;
+        }
+        IRVisitor::visit(op);
+    }
+
+public:
+    int loops = 0, non_constant_extents = 0;
+};
+
+int main(int argc, char **argv) {
+    // Build the Generator with the same GeneratorParams as the AOT
+    // test, and check the code it produces.
+    auto gen = GeneratorRegistry::create("specialize_buffer_shapes",
+                                         GeneratorContext(get_jit_target_from_environment()));
+    gen->set_generator_and_schedule_param_values({{"input.extents", "96,50"},
+                                                  {"input.strides", "1,96"}});
+    Module m = gen->build_module("specialize_buffer_shapes");
+
+    FindSpecialization finder;
+    for (const LoweredFunc &fn : m.functions()) {
+        if (fn.name == "specialize_buffer_shapes") {
+            fn.body.accept(&finder);
+        }
+    }
+    if (!finder.result) {
+        printf("Expected the pipeline to be specialized on the input's shape\n");
+        return -1;
+    }
+
+    CountLoops specialized, general;
+    finder.result->then_case.accept(&specialized);
+    finder.result->else_case.accept(&general);
+
+    // Every loop in the specialized path has a constant extent...
+    if (specialized.loops == 0 || specialized.non_constant_extents != 0) {
+        printf("Expected constant loop extents in the specialized path, "
+               "but %d of its %d loops have non-constant extents\n",
+               specialized.non_constant_extents, specialized.loops);
+        return -1;
+    }
+
+    // ...and there is no loop over the vector tail, which the general
+    // path needs.
+    if (general.non_constant_extents == 0) {
+        printf("Expected non-constant loop extents in the general path\n");
+        return -1;
+    }
+    if (specialized.loops >= general.loops) {
+        printf("Expected the specialized path to have no vector tail, but it has %d loops "
+               "to the general path's %d\n", specialized.loops, general.loops);
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "HalideRuntime.h"
+#include "HalideBuffer.h"
+
+#include "split_static_library.h"
+
+using namespace Halide::Runtime;
+
+uint16_t expected(const Buffer<uint8_t> &input, int x, int y, int n) {
+    auto clamp = [](int v, int lo, int hi) { return v < lo ? lo : (v > hi ? hi : v); };
+    uint16_t sum = 0;
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            sum += input(clamp(x + dx, 0, input.width() - 1),
+                         clamp(y + dy, 0, input.height() - 1), n);
+        }
+    }
+    return sum;
+}
+
+int main(int argc, char **argv) {
+    const int W = 123, H = 45, N = 3;
+
+    Buffer<uint8_t> input(W, H, N);
+    input.for_each_element([&](int x, int y, int n) {
+        input(x, y, n) = (uint8_t)(x * 7 + y * 13 + n * 29);
+    });
+
+    // Both functions in the library link and run.
+    Buffer<uint16_t> batch_output(W, H, N);
+    int result = split_static_library_batch(input, batch_output);
+    if (result != 0) {
+        printf("split_static_library_batch failed: %d\n", result);
+        return -1;
+    }
+
+    for (int n = 0; n < N; n++) {
+        Buffer<uint16_t> output(W, H);
+        result = split_static_library(input.sliced(2, n), output);
+        if (result != 0) {
+            printf("split_static_library failed: %d\n", result);
+            return -1;
+        }
+        output.for_each_element([&](int x, int y) {
+            uint16_t correct = expected(input, x, y, n);
+            if (output(x, y) != correct || batch_output(x, y, n) != correct) {
+                printf("output(%d, %d) = %d and batch_output(%d, %d, %d) = %d instead of %d\n",
+                       x, y, output(x, y), x, y, n, batch_output(x, y, n), correct);
+                exit(-1);
+            }
+        });
+    }
+
+    printf("Success!\n");
+    return 0;
+}
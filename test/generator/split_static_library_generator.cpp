@@ -0,0 +1,31 @@
+#include "Halide.h"
+
+namespace {
+
+// Built with batch_entry_point=true, so its static library holds two
+// functions, which are compiled to separate objects in parallel.
+class SplitStaticLibrary : public Halide::Generator<SplitStaticLibrary> {
+public:
+    Input<Buffer<uint8_t>> input{ "input", 2 };
+
+    Output<Buffer<uint16_t>> output{ "output", 2 };
+
+    void generate() {
+        Func in = Halide::BoundaryConditions::repeat_edge(input);
+        blur_x(x, y) = cast<uint16_t>(in(x - 1, y)) + in(x, y) + in(x + 1, y);
+        output(x, y) = blur_x(x, y - 1) + blur_x(x, y) + blur_x(x, y + 1);
+    }
+
+    void schedule() {
+        output.split(y, y, yi, 8).parallel(y).vectorize(x, natural_vector_size<uint16_t>());
+        blur_x.compute_at(output, y).vectorize(x, natural_vector_size<uint16_t>());
+    }
+
+private:
+    Var x{"x"}, y{"y"}, yi{"yi"};
+    Func blur_x{"blur_x"};
+};
+
+}  // namespace
+
+HALIDE_REGISTER_GENERATOR(SplitStaticLibrary, split_static_library)
@@ -0,0 +1,60 @@
+#include "Halide.h"
+#include <cstdio>
+#include "halide_benchmark.h"
+
+using namespace Halide;
+using namespace Halide::Tools;
+
+// A final parallel loop writing a frame much larger than the
+// last-level cache. Non-temporal stores avoid reading each line of
+// the output in before overwriting it, and leave the cache to the
+// input.
+int main(int argc, char **argv) {
+    const int W = 3840 * 2, H = 2160 * 2;
+
+    ImageParam in(UInt(8), 2);
+    Var x, y;
+
+    Buffer<uint8_t> input(W + 2, H);
+    input.for_each_element([&](int x, int y) {
+        input(x, y) = (uint8_t)(x * 3 + y);
+    });
+    in.set(input);
+
+    Func regular, streamed;
+    for (Func *f : {&regular, &streamed}) {
+        (*f)(x, y) = cast<uint32_t>(in(x, y)) + in(x + 1, y) + in(x + 2, y);
+        f->vectorize(x, 16).parallel(y, 16);
+        // The stores need to be known to be aligned to the vector
+        // width to use non-temporal instructions.
+        f->output_buffer()
+            .set_host_alignment(64)
+            .dim(0).set_bounds(0, W)
+            .dim(1).set_stride(W);
+    }
+    streamed.store_non_temporal();
+
+    Buffer<uint32_t> out_regular(W, H), out_streamed(W, H);
+    regular.compile_jit();
+    streamed.compile_jit();
+
+    double t_regular = benchmark(10, 5, [&]() { regular.realize(out_regular); });
+    double t_streamed = benchmark(10, 5, [&]() { streamed.realize(out_streamed); });
+
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            if (out_streamed(x, y) != out_regular(x, y)) {
+                printf("out(%d, %d) = %u instead of %u\n",
+                       x, y, out_streamed(x, y), out_regular(x, y));
+                return -1;
+            }
+        }
+    }
+
+    printf("Regular stores: %f ms\n"
+           "Non-temporal stores: %f ms\n",
+           t_regular * 1e3, t_streamed * 1e3);
+
+    printf("Success!\n");
+    return 0;
+}
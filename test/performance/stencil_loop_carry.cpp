@@ -0,0 +1,78 @@
+#include "Halide.h"
+#include <cstdio>
+#include "halide_benchmark.h"
+
+using namespace Halide;
+using namespace Halide::Tools;
+
+// Stencils walking down columns of vectors reload most of their
+// inputs on every iteration. On CPU targets the code generator keeps
+// the overlapping rows in registers across iterations instead. Time
+// the same schedule with and without that.
+int test_stencil(int taps) {
+    const int W = 1536, H = 2048;
+
+    ImageParam in(UInt(16), 2);
+    Var x, y, xo, xi;
+
+    Expr sum = cast<uint16_t>(0);
+    for (int j = 0; j < taps; j++) {
+        for (int i = 0; i < taps; i++) {
+            sum += in(x + i, y + j) * (i + j + 1);
+        }
+    }
+
+    // Walk down each column of vectors, so that each row loaded is
+    // reused by the next taps - 1 iterations.
+    Func carried, uncarried;
+    for (Func f : {carried, uncarried}) {
+        f(x, y) = sum;
+        f.split(x, xo, xi, 16).reorder(xi, y, xo).vectorize(xi).parallel(xo);
+    }
+
+    Buffer<uint16_t> input(W + taps, H + taps);
+    input.for_each_value([](uint16_t &v) {v = rand() & 0xfff;});
+    in.set(input);
+
+    Target target = get_jit_target_from_environment();
+    Target no_carry = target.with_feature(Target::NoLoopCarry);
+
+    Buffer<uint16_t> out_carried(W, H), out_uncarried(W, H);
+    carried.compile_jit(target);
+    uncarried.compile_jit(no_carry);
+
+    double t_carried = benchmark(10, 10, [&]() { carried.realize(out_carried, target); });
+    double t_uncarried = benchmark(10, 10, [&]() { uncarried.realize(out_uncarried, no_carry); });
+
+    for (int j = 0; j < H; j++) {
+        for (int i = 0; i < W; i++) {
+            if (out_carried(i, j) != out_uncarried(i, j)) {
+                printf("%dx%d stencil: out(%d, %d) = %d instead of %d\n",
+                       taps, taps, i, j, out_carried(i, j), out_uncarried(i, j));
+                return -1;
+            }
+        }
+    }
+
+    printf("%dx%d stencil:\n"
+           "  with carried rows: %f ms\n"
+           "  without carried rows: %f ms\n",
+           taps, taps, t_carried * 1e3, t_uncarried * 1e3);
+
+    if (t_carried >= t_uncarried) {
+        printf("Carrying rows across iterations did not speed up the %dx%d stencil\n", taps, taps);
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    for (int taps : {3, 5, 7}) {
+        if (test_stencil(taps)) {
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -449,6 +449,39 @@ Buffer<> allocate_buffer(const halide_type_t &type, const Shape &shape) {
     return b;
 }
 
+// If the output is to be saved in .tmp format and the shape is one
+// that a .tmp file can hold as-is (dense, planar, zero mins, at most
+// four dimensions), create the file and map it, so that the filter
+// writes its output straight into the file. Returns false if the
+// output can't be mapped.
+bool map_output_buffer(const std::string &pathname, const halide_type_t &type, const Shape &shape,
+                       Buffer<> *buf, Halide::Tools::MappedFileHandle *mapping) {
+    if (pathname.empty() ||
+        Halide::Tools::Internal::get_lowercase_extension(pathname) != "tmp" ||
+        shape.size() > 4) {
+        return false;
+    }
+    std::vector<int> extents;
+    int64_t stride = 1;
+    for (const auto &d : shape) {
+        if (d.min != 0 || d.stride != stride) {
+            return false;
+        }
+        extents.push_back(d.extent);
+        stride *= d.extent;
+    }
+    Buffer<> b;
+    if (!Halide::Tools::create_mapped_tmp<Buffer<>>(pathname, type, extents, &b, mapping)) {
+        return false;
+    }
+    // .tmp files are always four-dimensional.
+    while (b.dimensions() > (int) shape.size()) {
+        b = b.sliced(b.dimensions() - 1, 0);
+    }
+    *buf = b;
+    return true;
+}
+
 // BEGIN TODO: hacky algorithm inspired by Safelight
 // (should really use the algorithm from AddImageChecks to come up with something more rigorous.)
 Shape choose_output_extents(int dimensions, const Shape &defaults) {
@@ -612,13 +645,23 @@ Buffer<> adjust_buffer_dims(const std::string &title, const std::string &name, c
 }
 
 // Load a buffer from a pathname, adjusting the type and dimensions to
-// fit the metadata's requirements as needed.
+// fit the metadata's requirements as needed. Files in .tmp format of
+// the right type are memory-mapped rather than read; in that case
+// *mapping is set and must outlive the returned buffer.
 Buffer<> load_input_from_file(const std::string &pathname,
-                              const halide_filter_argument_t &metadata) {
+                              const halide_filter_argument_t &metadata,
+                              Halide::Tools::MappedFileHandle *mapping) {
     Buffer<> b = Buffer<>(metadata.type, 0);
-    info() << "Loading input " << metadata.name << " from " << pathname << " ...";
-    if (!Halide::Tools::load<Buffer<>, IOCheckFail>(pathname, &b)) {
-        fail() << "Unable to load input: " << pathname;
+    if (Halide::Tools::Internal::get_lowercase_extension(pathname) == "tmp" &&
+        Halide::Tools::map_tmp<Buffer<>>(pathname, &b, mapping) &&
+        b.type() == metadata.type) {
+        info() << "Mapped input " << metadata.name << " from " << pathname;
+    } else {
+        mapping->reset();
+        info() << "Loading input " << metadata.name << " from " << pathname << " ...";
+        if (!Halide::Tools::load<Buffer<>, IOCheckFail>(pathname, &b)) {
+            fail() << "Unable to load input: " << pathname;
+        }
     }
     if (b.dimensions() != metadata.dimensions) {
         b = adjust_buffer_dims("Input", metadata.name, metadata.dimensions, b);
@@ -633,10 +676,11 @@ Buffer<> load_input_from_file(const std::string &pathname,
 }
 
 Buffer<> load_input(const std::string &pathname,
-                    const halide_filter_argument_t &metadata) {
+                    const halide_filter_argument_t &metadata,
+                    Halide::Tools::MappedFileHandle *mapping) {
     std::vector<std::string> v = split_string(pathname, ":");
     if (v.size() != 2 || v[0].size() == 1) {
-        return load_input_from_file(pathname, metadata);
+        return load_input_from_file(pathname, metadata, mapping);
     }
 
     // Assume it's a special std::string of the form key:values
@@ -661,6 +705,8 @@ struct ArgData {
     std::string raw_string;
     halide_scalar_value_t scalar_value;
     Buffer<> buffer_value;
+    // Non-null if buffer_value points into a memory-mapped file.
+    Halide::Tools::MappedFileHandle mapping;
 };
 
 // Run a bounds-query call with the given args, and return the shapes
@@ -745,13 +791,19 @@ Arguments:
         some_input_buffer=/path/to/existing/file.png
         some_output_buffer=/path/to/create/output/file.png
 
-    We currently support JPG, PGM, PNG, PPM format. If the type or dimensions
-    of the input or output file type can't support the data (e.g., your filter
-    uses float32 input and output, and you load/save to PNG), we'll use the most
-    robust approximation within the format and issue a warning to stdout.
+    We currently support JPG, PGM, PNG, PPM, and TMP format. If the type or
+    dimensions of the input or output file type can't support the data (e.g.,
+    your filter uses float32 input and output, and you load/save to PNG), we'll
+    use the most robust approximation within the format and issue a warning to
+    stdout.
+
+    TMP inputs of the expected type are memory-mapped rather than read, and
+    TMP outputs with a dense planar shape are realized directly into a
+    memory-mapped file, so very large images can be used without parsing
+    or copying them. (Memory-mapping is not available on Windows.)
 
     (We anticipate adding other image formats in the future, in particular,
-    TIFF and TMP.)
+    TIFF.)
 
     For inputs, there are also "pseudo-file" specifiers you can use; currently
     supported are
@@ -1041,7 +1093,7 @@ int main(int argc, char **argv) {
             break;
         }
         case halide_argument_kind_input_buffer: {
-            arg.buffer_value = load_input(arg.raw_string, *arg.metadata);
+            arg.buffer_value = load_input(arg.raw_string, *arg.metadata, &arg.mapping);
             info() << "Input " << arg_name << ": Shape is " << get_shape(arg.buffer_value);
             // If there was no default_output_shape specified, use the shape of
             // the first input buffer (if any).
@@ -1076,7 +1128,10 @@ int main(int argc, char **argv) {
                 break;
             }
             case halide_argument_kind_output_buffer: {
-                arg.buffer_value = allocate_buffer(arg.metadata->type, make_legal_output_buffer_shape(constrained_shape));
+                Shape shape = make_legal_output_buffer_shape(constrained_shape);
+                if (!map_output_buffer(arg.raw_string, arg.metadata->type, shape, &arg.buffer_value, &arg.mapping)) {
+                    arg.buffer_value = allocate_buffer(arg.metadata->type, shape);
+                }
                 info() << "Output " << arg_name << ": BoundsQuery result is " << constrained_shape;
                 info() << "Output " << arg_name << ": Shape is " << get_shape(arg.buffer_value);
                 break;
@@ -1164,7 +1219,13 @@ int main(int argc, char **argv) {
         auto &arg_name = arg_pair.first;
         auto &arg = arg_pair.second;
         if (arg.metadata->kind == halide_argument_kind_output_buffer) {
-            if (!arg.raw_string.empty()) {
+            if (arg.mapping) {
+                // The output was realized directly into the file.
+                arg.buffer_value.copy_to_host();
+                arg.buffer_value = Buffer<>();
+                arg.mapping.reset();
+                info() << "Output " << arg_name << " was written directly to " << arg.raw_string;
+            } else if (!arg.raw_string.empty()) {
                 info() << "Saving output " << arg_name << " to " << arg.raw_string << " ...";
                 Buffer<> &b = arg.buffer_value;
 
@@ -8,8 +8,10 @@
 #include <cstdarg>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -22,6 +24,17 @@
 #include "jpeglib.h"
 #endif
 
+#if defined(_WIN32) && !defined(HALIDE_NO_MMAP)
+#define HALIDE_NO_MMAP
+#endif
+
+#ifndef HALIDE_NO_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "HalideRuntime.h"  // for halide_type_t
 
 namespace Halide {
@@ -929,6 +942,99 @@ bool save_tmp(ImageType &im, const std::string &filename) {
     return true;
 }
 
+// A file mapped into memory. The mapping lasts as long as this
+// object does.
+class MappedFile {
+public:
+#ifndef HALIDE_NO_MMAP
+    // Map an existing file. If writable is true, writes to the
+    // mapping are written back to the file; otherwise the mapping is
+    // copy-on-write, so the memory may still be modified without
+    // changing the file.
+    MappedFile(const std::string &filename, bool writable) {
+        int fd = open(filename.c_str(), writable ? O_RDWR : O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            map(fd, (size_t) st.st_size, writable ? MAP_SHARED : MAP_PRIVATE);
+        }
+        close(fd);
+    }
+
+    // Create (or truncate) a file of the given size, and map it so
+    // that writes to the mapping are written back to the file.
+    MappedFile(const std::string &filename, size_t size) {
+        int fd = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            return;
+        }
+        if (size > 0 && ftruncate(fd, (off_t) size) == 0) {
+            map(fd, size, MAP_SHARED);
+        }
+        close(fd);
+    }
+
+    ~MappedFile() {
+        if (data != nullptr) {
+            munmap(data, size);
+        }
+    }
+#else
+    MappedFile(const std::string &filename, bool writable) {}
+    MappedFile(const std::string &filename, size_t size) {}
+#endif
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    uint8_t *data = nullptr;
+    size_t size = 0;
+
+private:
+#ifndef HALIDE_NO_MMAP
+    void map(int fd, size_t sz, int flags) {
+        void *ptr = mmap(nullptr, sz, PROT_READ | PROT_WRITE, flags, fd, 0);
+        if (ptr != MAP_FAILED) {
+            data = (uint8_t *) ptr;
+            size = sz;
+        }
+    }
+#endif
+};
+
+// Wrap size bytes of a mapped file starting at offset in an image of
+// the given type and extents, without copying. Fails if the mapping
+// is too small, or the data isn't aligned to the element size.
+template<typename ImageType, CheckFunc check>
+bool wrap_mapped_file(const std::shared_ptr<MappedFile> &file, size_t offset,
+                      halide_type_t type, const std::vector<int> &extents,
+                      ImageType *im) {
+    if (!check(file->data != nullptr, "File could not be memory-mapped")) {
+        return false;
+    }
+    const size_t elem_size = type.bytes();
+    size_t count = elem_size;
+    for (int e : extents) {
+        if (!check(e > 0, "Extents of a mapped image must be positive")) {
+            return false;
+        }
+        count *= (size_t) e;
+    }
+    if (!check(offset + count <= file->size, "Mapped file is too small for the requested image")) {
+        return false;
+    }
+    if (!check((offset % elem_size) == 0, "Mapped image data is not aligned to its element size")) {
+        return false;
+    }
+    *im = ImageType(type, file->data + offset, extents);
+    return true;
+}
+
+// The size in bytes of a .tmp file header.
+constexpr size_t kTmpHeaderSize = 5 * sizeof(int32_t);
+
 template<typename ImageType, Internal::CheckFunc check>
 struct ImageIO {
     std::function<bool(const std::string &, ImageType *)> load;
@@ -1242,6 +1348,122 @@ bool save_query(const std::string &filename, std::set<FormatInfo> *info) {
     return true;
 }
 
+// A handle that keeps a memory-mapped image alive. Images returned by
+// the map_* functions below point directly into the mapping, so they
+// (and any Buffers aliasing them) must not be used after the last
+// copy of the handle is destroyed.
+using MappedFileHandle = std::shared_ptr<Internal::MappedFile>;
+
+// Memory-map a headerless file containing densely-packed planar data
+// of the given type and extents, starting at the given byte offset,
+// and wrap it in an image without copying or parsing. If writable is
+// true, writes to the image are written back to the file; otherwise
+// the mapping is copy-on-write. Returns false upon failure.
+template<typename ImageType, Internal::CheckFunc check = Internal::CheckReturn>
+bool map_raw(const std::string &filename, halide_type_t type, const std::vector<int> &extents,
+             ImageType *im, MappedFileHandle *mapping, bool writable = false, size_t offset = 0) {
+    static_assert(!ImageType::has_static_halide_type, "");
+    auto file = std::make_shared<Internal::MappedFile>(filename, writable);
+    if (!Internal::wrap_mapped_file<ImageType, check>(file, offset, type, extents, im)) {
+        return false;
+    }
+    *mapping = file;
+    return true;
+}
+
+// Create a file of the right size for densely-packed planar data of
+// the given type and extents, memory-map it, and wrap it in an image
+// without copying. Anything written to the image ends up in the
+// file, so realizing a pipeline into it saves the output with no
+// extra copy. Returns false upon failure.
+template<typename ImageType, Internal::CheckFunc check = Internal::CheckReturn>
+bool create_mapped_raw(const std::string &filename, halide_type_t type, const std::vector<int> &extents,
+                       ImageType *im, MappedFileHandle *mapping) {
+    static_assert(!ImageType::has_static_halide_type, "");
+    size_t size = type.bytes();
+    for (int e : extents) {
+        size *= (size_t) std::max(e, 0);
+    }
+    auto file = std::make_shared<Internal::MappedFile>(filename, size);
+    if (!Internal::wrap_mapped_file<ImageType, check>(file, 0, type, extents, im)) {
+        return false;
+    }
+    *mapping = file;
+    return true;
+}
+
+// Like load_tmp(), but memory-maps the file and wraps the payload
+// directly rather than reading it into a freshly-allocated image.
+// Note that the payload of a .tmp file is only aligned to 4 bytes, so
+// this fails for 64-bit element types. Returns false upon failure.
+template<typename ImageType, Internal::CheckFunc check = Internal::CheckReturn>
+bool map_tmp(const std::string &filename, ImageType *im, MappedFileHandle *mapping, bool writable = false) {
+    static_assert(!ImageType::has_static_halide_type, "");
+    auto file = std::make_shared<Internal::MappedFile>(filename, writable);
+    if (!check(file->data != nullptr, "File could not be memory-mapped")) {
+        return false;
+    }
+    if (!check(file->size >= Internal::kTmpHeaderSize, "Count not read .tmp header")) {
+        return false;
+    }
+    int32_t header[5];
+    memcpy(&header[0], file->data, sizeof(header));
+    if (!check(header[0] > 0 && header[1] > 0 && header[2] > 0 && header[3] > 0 &&
+               header[4] >= 0 && header[4] < Internal::kNumTmpCodes, "Bad header on .tmp file")) {
+        return false;
+    }
+    const halide_type_t im_type = Internal::tmp_code_to_halide_type()[header[4]];
+    std::vector<int> im_dimensions = { header[0], header[1], header[2], header[3] };
+    if (!Internal::wrap_mapped_file<ImageType, check>(file, Internal::kTmpHeaderSize, im_type, im_dimensions, im)) {
+        return false;
+    }
+    *mapping = file;
+    return true;
+}
+
+// Create a .tmp file for an image of the given type and extents (at
+// most four), memory-map it, and wrap the payload in an image. As with
+// map_tmp(), the image is always four-dimensional, with missing
+// trailing extents set to one. The file is complete as soon as the
+// image has been written to. Returns false upon failure.
+template<typename ImageType, Internal::CheckFunc check = Internal::CheckReturn>
+bool create_mapped_tmp(const std::string &filename, halide_type_t type, const std::vector<int> &extents,
+                       ImageType *im, MappedFileHandle *mapping) {
+    static_assert(!ImageType::has_static_halide_type, "");
+    if (!check(extents.size() <= 4, ".tmp files support at most four dimensions")) {
+        return false;
+    }
+    int32_t header[5] = { 1, 1, 1, 1, -1 };
+    for (size_t i = 0; i < extents.size(); ++i) {
+        header[i] = extents[i];
+    }
+    auto *table = Internal::tmp_code_to_halide_type();
+    for (int i = 0; i < Internal::kNumTmpCodes; i++) {
+        if (type == table[i]) {
+            header[4] = i;
+            break;
+        }
+    }
+    if (!check(header[4] >= 0, "Unsupported type for .tmp file")) {
+        return false;
+    }
+    size_t payload = type.bytes();
+    for (int e : extents) {
+        payload *= (size_t) std::max(e, 0);
+    }
+    auto file = std::make_shared<Internal::MappedFile>(filename, Internal::kTmpHeaderSize + payload);
+    if (!check(file->data != nullptr, "File could not be memory-mapped")) {
+        return false;
+    }
+    memcpy(file->data, &header[0], sizeof(header));
+    std::vector<int> im_dimensions = { header[0], header[1], header[2], header[3] };
+    if (!Internal::wrap_mapped_file<ImageType, check>(file, Internal::kTmpHeaderSize, type, im_dimensions, im)) {
+        return false;
+    }
+    *mapping = file;
+    return true;
+}
+
 // Fancy wrapper to call load() with CheckFail, inferring the return type;
 // this allows you to simply use
 //